@@ -0,0 +1,219 @@
+﻿/****************************************************************
+ * @file    gsapi_async_client.h
+ * @brief   GameSynth Tool APIを非同期に呼び出す
+ * @version 1.0.4
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_ASYNC_CLIENT_H
+#define GSAPI_ASYNC_CLIENT_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_codec.h"
+#include "gsapi_connection.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+
+/* 非同期コマンドの結果 */
+template <typename T = void>
+struct GsAsyncResult {
+    bool    result = false;                                                     /* 応答を受け取り、解析できたか */
+    T       value{};                                                            /* 応答から取り出した値 */
+};
+
+/* 値を返さない非同期コマンドの結果 */
+template <>
+struct GsAsyncResult<void> {
+    bool    result = false;                                                     /* 応答を受け取ったか */
+};
+
+/* 非同期コマンドの完了通知(I/Oスレッドで呼ばれる) */
+template <typename T = void>
+using GsCompletion = std::function<void(const GsAsyncResult<T>&)>;
+
+/* 応答の受け取り(I/Oスレッドで呼ばれ、responseは呼び出し中のみ有効) */
+typedef std::function<void(bool result, std::string_view response)> GsResponseHandler;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * 専用のI/Oスレッドがソケットを持ち、送信したコマンドの応答を順に受け取る。
+ * コマンドは応答を待たずに続けて送るので、スレッドを増やさずに多数のコマンドを
+ * 同時に処理できる。各コマンドはfutureを返し、completionを渡せば完了時にも
+ * 呼び出す。I/Oスレッドを止めないよう、completionの中で結果を待たないこと。
+ * completionの中でstopを呼んでもよいが、破棄してはならない(I/Oスレッドが使用中)。
+ */
+class gsapi_async_client
+{
+public:
+    gsapi_async_client();
+    ~gsapi_async_client();
+    gsapi_async_client(const gsapi_async_client&) = delete;
+    gsapi_async_client& operator=(const gsapi_async_client&) = delete;
+
+    /**************************************************************************
+     * @brief   I/Oスレッドを開始する。ツールへは最初のコマンドで接続する。
+     * @param   config : 通信設定の参照
+     * @return  開始できればtrueを返す。既に開始していればfalseを返す。
+     **************************************************************************/
+    bool start(const GsApiClientConfig& config);
+    /**************************************************************************
+     * @brief   I/Oスレッドを止める。応答待ちのコマンドはfalseで完了する。
+     *          completionの中で呼んだ場合は終了を待たずに戻り、I/Oスレッドはcompletionから
+     *          戻った後に終わる。その場合、再びstartする前に別のスレッドからstopを呼ぶこと。
+     **************************************************************************/
+    void stop();
+    /**************************************************************************
+     * @brief   I/Oスレッドが動いているか。
+     * @return  動いていればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_running() const;
+
+    /**************************************************************************
+     * @brief   メッセージを送り、応答をhandlerで受け取る。
+     * @param   message : デリミタで終わる1つのコマンド
+     * @param   handler : 応答(デリミタを除く)を受け取る関数。期限までに応答が
+     *          なければfalseで呼ばれる。
+     * @return  送信を受け付ければtrueを返す。停止中はfalseを返し、handlerは呼ばない。
+     **************************************************************************/
+    bool send_command(const std::string& message, const GsResponseHandler& handler);
+    /**************************************************************************
+     * @brief   メッセージを送り、応答をfutureで受け取る。
+     * @param   message : デリミタで終わる1つのコマンド
+     * @return  応答(デリミタを除く)を受け取るfuture
+     **************************************************************************/
+    std::future<GsAsyncResult<std::string>> send_command(const std::string& message);
+
+public:
+    /* GameSynth Tool APIを非同期に利用する関数。引数と応答の意味はgsapi_clientの同名関数と同じ。
+       値の型と応答の解析はGSAPI_COMMAND_TABLEの応答の種類で決まる */
+
+    std::future<GsAsyncResult<std::string>> command_get_version(const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_get_commands(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_get_models(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_select_model(const std::string& model_name, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_path(const std::string& path_name, const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_samplerate(const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_samplerate(const std::string& samplerate, const GsCompletion<>& completion = nullptr);
+
+    std::future<GsAsyncResult<std::vector<std::string>>> command_query_patchnames(const std::string& text, const bool name,
+        const bool category, const bool tags, const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_query_patch(const std::string& patch_name, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_query_categories(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_query_tags(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+
+    std::future<GsAsyncResult<>> command_load_patch(const std::string& file_path, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_save_patch(const std::string& file_path, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_render_patch(const std::string& file_path, const unsigned int depth,
+        const unsigned int channel, const unsigned int duration, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_modelname(const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_patchname(const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<float>> command_get_variation(const GsCompletion<float>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_variation(const float& variation, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<GsDrawingData>>> command_get_drawing(const unsigned int index,
+        const GsCompletion<std::vector<GsDrawingData>>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_drawing(const std::vector<GsDrawingData>& drawing_data, const GsCompletion<>& completion = nullptr);
+
+    std::future<GsAsyncResult<unsigned int>> command_get_metacount(const GsCompletion<unsigned int>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_get_metanames(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_metaname(const unsigned int& index, const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<float>> command_get_metavalue(const unsigned int& index, const GsCompletion<float>& completion = nullptr);
+    std::future<GsAsyncResult<float>> command_get_metavalue(const std::string& name, const GsCompletion<float>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_metavalue(const unsigned int& index, const float& metavalue, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_metavalue(const std::string& name, const float& metavalue, const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues, const GsCompletion<>& completion = nullptr);
+
+    std::future<GsAsyncResult<unsigned int>> command_get_curvescount(const GsCompletion<unsigned int>& completion = nullptr);
+    std::future<GsAsyncResult<std::vector<std::string>>> command_get_curvenames(const GsCompletion<std::vector<std::string>>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_get_curvename(const unsigned int& curve_index, const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<GsCurveValue>> command_get_curvevalue(const unsigned int& curve_index, const GsCompletion<GsCurveValue>& completion = nullptr);
+    std::future<GsAsyncResult<GsCurveValue>> command_get_curvevalue(const std::string& curve_name, const GsCompletion<GsCurveValue>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value,
+        const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value,
+        const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values, const GsCompletion<>& completion = nullptr);
+
+    std::future<GsAsyncResult<>> command_play(const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_stop(const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<bool>> command_is_playing(const GsCompletion<bool>& completion = nullptr);
+    std::future<GsAsyncResult<bool>> command_is_infinite(const GsCompletion<bool>& completion = nullptr);
+    std::future<GsAsyncResult<bool>> command_is_randomized(const GsCompletion<bool>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_enable_events(const bool is_notification, const GsCompletion<>& completion = nullptr);
+
+    std::future<GsAsyncResult<>> command_window_back(const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_window_front(const GsCompletion<>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_window_message(const std::string& message, const GsWindowButton& button,
+        const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_window_parameters(const std::vector<GsParameter>& params, const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<std::string>> command_window_rendering(const bool& show_duration, const bool& show_variations,
+        const GsCompletion<std::string>& completion = nullptr);
+    std::future<GsAsyncResult<>> command_window_test(const GsCompletion<>& completion = nullptr);
+
+private:
+    /* 送信を受け付けたコマンド */
+    typedef struct GsAsyncRequestStruct {
+        std::string         message;                                            /* 送信するメッセージ */
+        GsResponseHandler   handler;                                            /* 応答の受け取り */
+    } GsAsyncRequest;
+
+    /* 応答待ちのコマンド */
+    typedef struct GsAsyncPendingStruct {
+        GsResponseHandler   handler;                                            /* 応答の受け取り */
+        std::chrono::steady_clock::time_point deadline;                         /* 応答の期限 */
+    } GsAsyncPending;
+
+    template <GsCommandId Id>
+    std::future<GsAsyncResult<GsReplyValue<Id>>> request(const bool is_encoded, const std::string& message,
+        const GsCompletion<GsReplyValue<Id>>& completion);
+    std::future<GsAsyncResult<>> request_batch(const std::vector<std::string>& messages, const GsCompletion<>& completion);
+
+    void run();
+    bool wait_events(const int timeout_msec, bool& is_readable, bool& is_writable);
+    void wake();
+    bool accept_requests();
+    bool flush_send();
+    bool receive_responses();
+    void update_interest();
+    void fail_all();
+    void close_socket();
+
+private:
+    GsApiClientConfig           config;                                         /* 通信設定 */
+    std::thread                 io_thread;                                      /* I/Oスレッド */
+    std::atomic<bool>           running;                                        /* I/Oスレッドが動いているか */
+    std::mutex                  mutex;                                          /* requests、epoll_fd、event_fdの排他 */
+    std::condition_variable     condition;                                      /* epollが使えない環境での起床通知 */
+    std::deque<GsAsyncRequest>  requests;                                       /* 送信を受け付けたコマンド */
+    int                         epoll_fd;                                       /* epollのディスクリプタ(start、stopで開閉) */
+    int                         event_fd;                                       /* I/Oスレッドを起こすeventfd(start、stopで開閉) */
+
+    /* 以下はI/Oスレッドだけが使う */
+    GsSocket                    sock;                                           /* 接続中のソケット */
+    bool                        is_waiting_writable;                            /* 送信可能を待っているか */
+    std::deque<GsAsyncRequest>  accepting;                                      /* 取り込み中のコマンド */
+    std::deque<GsAsyncPending>  pendings;                                       /* 応答待ちのコマンド(送信順) */
+    std::string                 send_buffer;                                    /* 未送信のデータ */
+    size_t                      send_offset;                                    /* 送信済みの位置 */
+    std::vector<char>           receive_buffer;                                 /* 受信バッファ */
+    size_t                      receive_begin;                                  /* 未読データの先頭位置 */
+    size_t                      receive_end;                                    /* 受信済みデータの末尾位置 */
+};
+
+#endif /* GSAPI_ASYNC_CLIENT_H */
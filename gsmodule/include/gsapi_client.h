@@ -1,7 +1,7 @@
 ﻿/****************************************************************
  * @file    gsapi_client.h
  * @brief   GameSynth Tool APIを呼び出す
- * @version 1.0.9
+ * @version 1.0.21
  * @auther  ysd
  ****************************************************************/
 #ifndef GSAPI_CLIENT_H
@@ -11,6 +11,7 @@
  * インクルード
  ****************************************************************/
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 
@@ -21,6 +22,9 @@
 #define GSAPI_CLIENT_DEFAULT_IP_ADDRESS     "127.0.0.1"                         /* デフォルトのIPアドレス */
 #define GSAPI_CLIENT_DEFAULT_CODEC          "UTF-8"                             /* デフォルトの圧縮形式 */
 #define GSAPI_CLIENT_DEFAULT_DELIMITER      "\r"                                /* デフォルトのデリミタ(10進コードで13) */
+#define GSAPI_CLIENT_DEFAULT_CONNECT_TIMEOUT_MSEC   (1000)                      /* デフォルトの接続期限 [ミリ秒] */
+#define GSAPI_CLIENT_DEFAULT_SEND_TIMEOUT_MSEC      (1000)                      /* デフォルトの送信期限 [ミリ秒] */
+#define GSAPI_CLIENT_DEFAULT_RECEIVE_TIMEOUT_MSEC   (10000)                     /* デフォルトの受信期限 [ミリ秒] */
 
 /****************************************************************
  * 構造体宣言
@@ -32,6 +36,13 @@ typedef struct GsApiClientConfigStruct {
     std::string     ip_address      = GSAPI_CLIENT_DEFAULT_IP_ADDRESS;          /* 接続先:IPアドレス*/
     std::string     codec           = GSAPI_CLIENT_DEFAULT_CODEC;               /* メッセージ:圧縮形式 */
     std::string     delimiter       = GSAPI_CLIENT_DEFAULT_DELIMITER;           /* メッセージ:デリミタ */
+    unsigned int    connect_timeout_msec = GSAPI_CLIENT_DEFAULT_CONNECT_TIMEOUT_MSEC;   /* 期限:接続 [ミリ秒] */
+    unsigned int    send_timeout_msec    = GSAPI_CLIENT_DEFAULT_SEND_TIMEOUT_MSEC;      /* 期限:送信 [ミリ秒] */
+    unsigned int    receive_timeout_msec = GSAPI_CLIENT_DEFAULT_RECEIVE_TIMEOUT_MSEC;   /* 期限:応答の受信 [ミリ秒] */
+    float           curve_max_error  = 0.f;                                     /* オートメーションカーブ:送信前に点を減らす許容誤差(0で無効) */
+    unsigned int    curve_max_points = 0;                                       /* オートメーションカーブ:送信する点の上限(0で無効) */
+    bool            mirror_cache     = false;                                   /* キャッシュ:パッチの情報を覚えて問い合わせを省く */
+    bool            resolve_names    = false;                                   /* キャッシュ:名前指定をインデックス指定に変換して送る */
 } GsApiClientConfig;
 
 /*スケッチパッドに描かれている曲線を格納する構造体 */
@@ -42,6 +53,9 @@ typedef struct GsDrawingDataStruct {
     float p = 0.f;                                                              /* 筆圧量[0…1] */
 } GsDrawingData;
 
+/* 要素ごとの配列で持つ曲線(gsapi_drawing.hで定義する) */
+typedef struct GsDrawingBufferStruct GsDrawingBuffer;
+
 /* オートメーションカーブの座標情報を格納する */
 typedef struct GsCurvePointStruct {
     float x = 0.f;                                                              /* X値 [0-1] */
@@ -55,6 +69,21 @@ typedef struct GsCurveValueStruct {
     bool                        is_loop = false;                                /* ループ情報 [0,1] */
 } GsCurveValue;
 
+/* メタパラメータやオートメーションカーブの指定(インデックスまたは名前) */
+typedef std::variant<unsigned int, std::string> GsTarget;
+
+/* まとめて設定するメタパラメータの値 */
+typedef struct GsMetaValueEntryStruct {
+    GsTarget                    target;                                         /* 設定先のインデックスまたは名前 */
+    float                       value = 0.f;                                    /* 設定する値 */
+} GsMetaValueEntry;
+
+/* まとめて設定するオートメーションカーブの値 */
+typedef struct GsCurveValueEntryStruct {
+    GsTarget                    target;                                         /* 設定先のインデックスまたは名前 */
+    GsCurveValue                value;                                          /* 設定する曲線 */
+} GsCurveValueEntry;
+
 /* メッセージボックスのボタン */
 typedef enum GsWindowButtonEnum {
     GS_WINDOW_BUTTON_OK = 0,                                                    /* OK */
@@ -155,6 +184,12 @@ typedef std::variant<GsNumber, GsBool, GsString, GsEnum, GsLabel> GsParameter;
 /****************************************************************
  * クラス宣言
  ****************************************************************/
+class gsapi_session;
+
+/*
+ * プロセスで共有する既定のセッション(gsapi_session)を操作する。
+ * 複数のツールを並行して操作するときは、ツールごとにgsapi_sessionを作る。
+ */
 class gsapi_client
 {
 public:
@@ -184,6 +219,29 @@ public:
      * @return  通信可能であればtrueを返す。それ以外の場合にfalseを返す。
      **************************************************************************/
     static bool is_connect();
+    /**************************************************************************
+     * @brief   覚えているパッチの情報を捨てる。次の取得はツールに問い合わせる。
+     **************************************************************************/
+    static void invalidate_mirror();
+
+    /**************************************************************************
+     * @brief   パイプラインを開始する。end_pipelineを呼ぶまで、各コマンドは送信せずに
+     *          蓄積し、応答を待たずにtrueを返す。取得系コマンドも蓄積するが、値を受け取れない
+     *          のでfalseを返す。応答はend_pipelineで送信した順に受け取る。
+     * @return  開始できればtrueを返す。既にパイプライン中ならfalseを返す。
+     **************************************************************************/
+    static bool begin_pipeline();
+    /**************************************************************************
+     * @brief   蓄積したコマンドを1つの接続で続けて送信し、すべての応答を待つ。
+     * @return  すべての応答を受け取ればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool end_pipeline();
+    /**************************************************************************
+     * @brief   蓄積したコマンドを1つの接続で続けて送信し、応答を送信した順に受け取る。
+     * @param   responses : 応答(デリミタを除く)を格納する配列の参照
+     * @return  すべての応答を受け取ればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool end_pipeline(std::vector<std::string>& responses);
 
 public:
     /* GameSynth Tool APIを利用する関数 */
@@ -315,12 +373,25 @@ public:
      * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
      **************************************************************************/
     static bool command_get_drawing(const unsigned int index, std::vector<GsDrawingData>& drawing_data);
+    /**************************************************************************
+     * @brief   パッチに設定された曲線を要素ごとの配列で取得する。
+     * @param   index : パッチに設定された曲線の番号
+     * @param   drawing_buffer : パッチに設定された曲線の情報を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool command_get_drawing(const unsigned int index, GsDrawingBuffer& drawing_buffer);
     /**************************************************************************
      * @brief   パッチに曲線を設定する。
      * @param   drawing_data : パッチに設定したい曲線の情報への参照
      * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
      **************************************************************************/
     static bool command_set_drawing(const std::vector<GsDrawingData>& drawing_data);
+    /**************************************************************************
+     * @brief   要素ごとの配列で持つ曲線をパッチに設定する。
+     * @param   drawing_buffer : パッチに設定したい曲線の情報への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool command_set_drawing(const GsDrawingBuffer& drawing_buffer);
 
     /**************************************************************************
      * @brief   パッチのメタパラメータ数を取得する。
@@ -369,6 +440,14 @@ public:
      * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
      **************************************************************************/
     static bool command_set_metavalue(const std::string& name, const float& metavalue);
+    /**************************************************************************
+     * @brief   パッチの複数のメタパラメータに値をまとめて設定する。
+     *          すべてのコマンドを1回の書き込みで送り、応答をまとめて待つ。
+     * @param   metavalues : 設定先と値の組の配列への参照
+     * @return  すべての値を送り、すべての応答があればtrueを返す。
+     *          送れない値(パッチにない名前など)があればfalseを返す。残りの値は送る。
+     **************************************************************************/
+    static bool command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues);
 
     /**************************************************************************
      * @brief   パッチのオートメーションカーブ数を取得する。
@@ -417,6 +496,14 @@ public:
      * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
      **************************************************************************/
     static bool command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   パッチの複数のオートメーションカーブに値をまとめて設定する。
+     *          すべてのコマンドを1回の書き込みで送り、応答をまとめて待つ。
+     * @param   curve_values : 設定先と曲線の組の配列への参照
+     * @return  すべての値を送り、すべての応答があればtrueを返す。
+     *          送れない値(パッチにない名前など)があればfalseを返す。残りの値は送る。
+     **************************************************************************/
+    static bool command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values);
 
     /**************************************************************************
      * @brief   パッチを再生する。
@@ -491,7 +578,11 @@ public:
 
 
 private:
-    static GsApiClientConfig gs_config;
+    /**************************************************************************
+     * @brief   プロセスで共有する既定のセッションを取得する。
+     * @return  既定のセッションの参照
+     **************************************************************************/
+    static gsapi_session& default_session();
 };
 
 #endif /* GSAPI_CLIENT_H */
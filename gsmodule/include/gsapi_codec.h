@@ -0,0 +1,281 @@
+﻿/****************************************************************
+ * @file    gsapi_codec.h
+ * @brief   GameSynth Tool APIのメッセージを作成し、応答を解析する
+ * @version 1.0.7
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_CODEC_H
+#define GSAPI_CODEC_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_commands.h"
+#include "gsapi_drawing.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 応答の種類ごとの値の型と解析(gsapi_codecの後ろで定める) */
+template <GsReplyType Reply>
+struct GsReplyTraits;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * 区切り文字で分けた文字列を、コピーせずに先頭から1つずつ取り出す。
+ * 取り出した文字列は元の文字列を指すので、元の文字列より長く使わないこと。
+ * 末尾の区切り文字の後ろは空の要素として扱わない("a,b," は "a" と "b")。
+ */
+class gsapi_tokenizer
+{
+public:
+    /**************************************************************************
+     * @brief   分割する文字列と区切り文字を指定する。
+     * @param   text : 分割する文字列
+     * @param   delimiter : 区切り文字
+     **************************************************************************/
+    gsapi_tokenizer(const std::string_view& text, const char delimiter);
+
+    /**************************************************************************
+     * @brief   次の要素を取り出す。
+     * @param   token : 要素を格納する参照
+     * @return  要素があればtrueを返す。残りがなければfalseを返す。
+     **************************************************************************/
+    bool next(std::string_view& token);
+    /**************************************************************************
+     * @brief   残りの要素の数を数える。配列の容量を確保するために使う。
+     * @return  残りの要素の数
+     **************************************************************************/
+    size_t count() const;
+
+private:
+    std::string_view    text;                                                   /* 分割する文字列 */
+    size_t              position;                                               /* 次の要素の先頭 */
+    char                delimiter;                                              /* 区切り文字 */
+};
+
+/*
+ * 送受信を伴わない、メッセージの組み立てと応答の解析だけを行う。
+ * encode_* は各コマンドの引数とデリミタから送信メッセージをmessageに作り、
+ * 作成できればtrueを返す。messageは上書きするが容量は使い回すため、同じ文字列を
+ * 渡し続ければ容量が足りている限りメモリを確保しない。数値はstd::to_charsで
+ * ロケールに依存せず、読み戻すと同じ値になる最短の表記にする。
+ * コマンド名はGSAPI_COMMAND_TABLE(gsapi_commands.h)から取り、渡す引数の並びは
+ * GsCommandSpecと照合して合わなければコンパイルできない。引数の型ごとの書式と
+ * 列挙値の文字列はgsapi_codec.cppの1か所で定める。
+ * decode_* は応答(デリミタを除く)を解析し、想定した形式であればtrueを返す。
+ * decode_replyはGSAPI_COMMAND_TABLEの応答の種類から decode_* を選ぶ。
+ */
+class gsapi_codec
+{
+public:
+    /* APIジャンル: GameSynth */
+    static bool encode_get_version(const std::string& delimiter, std::string& message);
+    static bool encode_get_commands(const std::string& delimiter, std::string& message);
+    static bool encode_get_models(const std::string& delimiter, std::string& message);
+    static bool encode_select_model(const std::string& model_name, const std::string& delimiter, std::string& message);
+    static bool encode_get_path(const std::string& path_name, const std::string& delimiter, std::string& message);
+    static bool encode_get_samplerate(const std::string& delimiter, std::string& message);
+    static bool encode_set_samplerate(const std::string& samplerate, const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: リポジトリ */
+    static bool encode_query_patchnames(const std::string& text, const bool name, const bool category, const bool tags,
+        const std::string& delimiter, std::string& message);
+    static bool encode_query_patch(const std::string& patch_name, const std::string& delimiter, std::string& message);
+    static bool encode_query_categories(const std::string& delimiter, std::string& message);
+    static bool encode_query_tags(const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: パッチ */
+    static bool encode_load_patch(const std::string& file_path, const std::string& delimiter, std::string& message);
+    static bool encode_save_patch(const std::string& file_path, const std::string& delimiter, std::string& message);
+    static bool encode_render_patch(const std::string& file_path, const unsigned int depth,
+        const unsigned int channel, const unsigned int duration, const std::string& delimiter, std::string& message);
+    static bool encode_get_modelname(const std::string& delimiter, std::string& message);
+    static bool encode_get_patchname(const std::string& delimiter, std::string& message);
+    static bool encode_get_variation(const std::string& delimiter, std::string& message);
+    static bool encode_set_variation(const float& variation, const std::string& delimiter, std::string& message);
+    static bool encode_get_drawing(const unsigned int index, const std::string& delimiter, std::string& message);
+    static bool encode_set_drawing(const std::vector<GsDrawingData>& drawing_data, const std::string& delimiter, std::string& message);
+    static bool encode_set_drawing(const GsDrawingBuffer& drawing_buffer, const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: メタパラメータ */
+    static bool encode_get_metacount(const std::string& delimiter, std::string& message);
+    static bool encode_get_metanames(const std::string& delimiter, std::string& message);
+    static bool encode_get_metaname(const unsigned int& index, const std::string& delimiter, std::string& message);
+    static bool encode_get_metavalue(const unsigned int& index, const std::string& delimiter, std::string& message);
+    static bool encode_get_metavalue(const std::string& name, const std::string& delimiter, std::string& message);
+    static bool encode_set_metavalue(const unsigned int& index, const float& metavalue, const std::string& delimiter, std::string& message);
+    static bool encode_set_metavalue(const std::string& name, const float& metavalue, const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: オートメーションカーブ */
+    static bool encode_get_curvescount(const std::string& delimiter, std::string& message);
+    static bool encode_get_curvenames(const std::string& delimiter, std::string& message);
+    static bool encode_get_curvename(const unsigned int& curve_index, const std::string& delimiter, std::string& message);
+    static bool encode_get_curvevalue(const unsigned int& curve_index, const std::string& delimiter, std::string& message);
+    static bool encode_get_curvevalue(const std::string& curve_name, const std::string& delimiter, std::string& message);
+    static bool encode_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value,
+        const std::string& delimiter, std::string& message);
+    static bool encode_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value,
+        const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: 再生 */
+    static bool encode_play(const std::string& delimiter, std::string& message);
+    static bool encode_stop(const std::string& delimiter, std::string& message);
+    static bool encode_is_playing(const std::string& delimiter, std::string& message);
+    static bool encode_is_infinite(const std::string& delimiter, std::string& message);
+    static bool encode_is_randomized(const std::string& delimiter, std::string& message);
+    static bool encode_enable_events(const bool is_notification, const std::string& delimiter, std::string& message);
+
+    /* APIジャンル: ウィンドウ */
+    static bool encode_window_back(const std::string& delimiter, std::string& message);
+    static bool encode_window_front(const std::string& delimiter, std::string& message);
+    static bool encode_window_message(const std::string& text, const GsWindowButton& button,
+        const std::string& delimiter, std::string& message);
+    static bool encode_window_parameters(const std::vector<GsParameter>& params, const std::string& delimiter, std::string& message);
+    static bool encode_window_rendering(const bool& show_duration, const bool& show_variations,
+        const std::string& delimiter, std::string& message);
+    static bool encode_window_test(const std::string& delimiter, std::string& message);
+
+public:
+    /**************************************************************************
+     * @brief   応答をそのまま文字列として受け取る。
+     * @param   response : 応答(デリミタを除く)
+     * @param   text : 応答を格納する参照
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool decode_text(const std::string_view& response, std::string& text);
+    /**************************************************************************
+     * @brief   カンマ区切りの応答を分割し、配列の末尾に追加する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   list : 分割した文字列を追加する配列の参照
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool decode_list(const std::string_view& response, std::vector<std::string>& list);
+    /**************************************************************************
+     * @brief   カンマ区切りの応答をコピーせずに分割し、配列の末尾に追加する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   list : 応答の中を指す文字列を追加する配列の参照。responseが有効な間だけ使える。
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool decode_list(const std::string_view& response, std::vector<std::string_view>& list);
+    /**************************************************************************
+     * @brief   小数の応答を解析する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   value : 値を格納する参照。解析できなければ変更しない。
+     * @return  数値であればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool decode_float(const std::string_view& response, float& value);
+    /**************************************************************************
+     * @brief   個数の応答を解析する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   count : 個数を格納する参照。解析できなければ変更しない。
+     * @return  数値であればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool decode_count(const std::string_view& response, unsigned int& count);
+    /**************************************************************************
+     * @brief   0または1の応答を真偽値として解析する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   flag : 1であればtrueを格納する参照。解析できなければ変更しない。
+     * @return  数値であればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool decode_flag(const std::string_view& response, bool& flag);
+    /**************************************************************************
+     * @brief   スケッチパッドの曲線 (t,x,y,p),(t,x,y,p),... を解析し、配列の末尾に追加する。
+     *          応答を1回だけ走査し、点の数だけ先に配列の容量を確保する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   drawing_data : 点を追加する配列の参照
+     * @return  常にtrueを返す。形式が合わない点は読み飛ばす。
+     **************************************************************************/
+    static bool decode_drawing(const std::string_view& response, std::vector<GsDrawingData>& drawing_data);
+    /**************************************************************************
+     * @brief   スケッチパッドの曲線を解析し、要素ごとの配列の末尾に追加する。
+     * @param   response : 応答(デリミタを除く)
+     * @param   drawing_buffer : 点を追加する曲線の参照
+     * @return  常にtrueを返す。形式が合わない点は読み飛ばす。
+     **************************************************************************/
+    static bool decode_drawing(const std::string_view& response, GsDrawingBuffer& drawing_buffer);
+    /**************************************************************************
+     * @brief   オートメーションカーブ "(x,y),(x,y),..." duration loop を解析する。
+     *          点の解析はdecode_drawingと同じく1回の走査で行う。
+     * @param   response : 応答(デリミタを除く)
+     * @param   curve_value : 曲線を格納する参照。点は末尾に追加する。
+     * @return  想定した形式であればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    static bool decode_curvevalue(const std::string_view& response, GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   コマンドの応答を、GSAPI_COMMAND_TABLEで定めた応答の種類で解析する。
+     *          応答を使わないコマンドは指定できない。
+     * @param   response : 応答(デリミタを除く)
+     * @param   value : 値を格納する参照。応答の種類に合う decode_* の引数の型にする。
+     * @return  選んだ decode_* の結果
+     **************************************************************************/
+    template <GsCommandId Id, typename T>
+    static bool decode_reply(const std::string_view& response, T& value)
+    {
+        return GsReplyTraits<gsapi_command(Id).reply>::decode(response, value);
+    }
+};
+
+/****************************************************************
+ * 構造体定義
+ ****************************************************************/
+template <>
+struct GsReplyTraits<GS_REPLY_NONE> {
+    typedef void value_type;                                                    /* 値を受け取らない */
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_TEXT> {
+    typedef std::string value_type;
+    static bool decode(const std::string_view& response, std::string& value) { return gsapi_codec::decode_text(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_LIST> {
+    typedef std::vector<std::string> value_type;
+    template <typename T>
+    static bool decode(const std::string_view& response, std::vector<T>& value) { return gsapi_codec::decode_list(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_FLOAT> {
+    typedef float value_type;
+    static bool decode(const std::string_view& response, float& value) { return gsapi_codec::decode_float(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_COUNT> {
+    typedef unsigned int value_type;
+    static bool decode(const std::string_view& response, unsigned int& value) { return gsapi_codec::decode_count(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_FLAG> {
+    typedef bool value_type;
+    static bool decode(const std::string_view& response, bool& value) { return gsapi_codec::decode_flag(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_DRAWING> {
+    typedef std::vector<GsDrawingData> value_type;
+    template <typename T>
+    static bool decode(const std::string_view& response, T& value) { return gsapi_codec::decode_drawing(response, value); }
+};
+
+template <>
+struct GsReplyTraits<GS_REPLY_CURVEVALUE> {
+    typedef GsCurveValue value_type;
+    static bool decode(const std::string_view& response, GsCurveValue& value) { return gsapi_codec::decode_curvevalue(response, value); }
+};
+
+/* コマンドの応答の値の型(応答を使わないコマンドはvoid) */
+template <GsCommandId Id>
+using GsReplyValue = typename GsReplyTraits<gsapi_command(Id).reply>::value_type;
+
+#endif /* GSAPI_CODEC_H */
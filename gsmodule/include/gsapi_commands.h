@@ -1,12 +1,25 @@
 ﻿/****************************************************************
  * @file    gsapi_commands.h
  * @brief   GameSynth Tool APIのコマンド一覧
- * @version 1.0.7
+ * @version 1.0.9
  * @auther  ysd
  ****************************************************************/
 #ifndef GSAPI_COMMANDS_H
 #define GSAPI_COMMANDS_H
 
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_drawing.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 /****************************************************************
  * プリプロセッサ定義
  ****************************************************************/
@@ -63,7 +76,268 @@
 #define GSAPI_WINDOW_FRONT             "window_front"          /* ツールのメインウィドウを前面に移動させる。 */
 #define GSAPI_WINDOW_MESSAGE           "window_message"        /* ツールのメッセージダイアログを表示する。 */
 #define GSAPI_WINDOW_PARAMETERS        "window_parameters"     /* ツールのパラメーター設定ダイアログを表示する。 */
-#define GSAPI_WINDOW_RENDERING         "window_rendering "     /* ツールのレンダリング設定ダイアログを表示する。 */
+#define GSAPI_WINDOW_RENDERING         "window_rendering"      /* ツールのレンダリング設定ダイアログを表示する。 */
 #define GSAPI_WINDOW_TEST              "window_test"           /* ツールのテスト用ダイアログを表示する。*/
 
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* コマンドの識別子(GSAPI_COMMAND_TABLEの並び順) */
+typedef enum GsCommandIdEnum {
+    GS_COMMAND_GET_VERSION = 0,                                                 /* GSAPI_GET_VERSION */
+    GS_COMMAND_GET_COMMANDS,                                                    /* GSAPI_GET_COMMANDS */
+    GS_COMMAND_GET_MODELS,                                                      /* GSAPI_GET_MODELS */
+    GS_COMMAND_SELECT_MODEL,                                                    /* GSAPI_SELECT_MODEL */
+    GS_COMMAND_GET_PATH,                                                        /* GSAPI_GET_PATH */
+    GS_COMMAND_GET_SAMPLERATE,                                                  /* GSAPI_GET_SAMPLERATE */
+    GS_COMMAND_SET_SAMPLERATE,                                                  /* GSAPI_SET_SAMPLERATE */
+    GS_COMMAND_QUERY_PATCHNAMES,                                                /* GSAPI_QUERY_PATCHNAMES */
+    GS_COMMAND_QUERY_PATCH,                                                     /* GSAPI_QUERY_PATCH */
+    GS_COMMAND_QUERY_CATEGORIES,                                                /* GSAPI_QUERY_CATEGORIES */
+    GS_COMMAND_QUERY_TAGS,                                                      /* GSAPI_QUERY_TAGS */
+    GS_COMMAND_LOAD_PATCH,                                                      /* GSAPI_LOAD_PATCH */
+    GS_COMMAND_SAVE_PATCH,                                                      /* GSAPI_SAVE_PATCH */
+    GS_COMMAND_RENDER_PATCH,                                                    /* GSAPI_RENDER_PATCH */
+    GS_COMMAND_GET_MODELNAME,                                                   /* GSAPI_GET_MODELNAME */
+    GS_COMMAND_GET_PATCHNAME,                                                   /* GSAPI_GET_PATCHNAME */
+    GS_COMMAND_GET_VARIATION,                                                   /* GSAPI_GET_VARIATION */
+    GS_COMMAND_SET_VARIATION,                                                   /* GSAPI_SET_VARIATION */
+    GS_COMMAND_GET_DRAWING,                                                     /* GSAPI_GET_DRAWING */
+    GS_COMMAND_SET_DRAWING,                                                     /* GSAPI_SET_DRAWING */
+    GS_COMMAND_GET_METACOUNT,                                                   /* GSAPI_GET_METACOUNT */
+    GS_COMMAND_GET_METANAMES,                                                   /* GSAPI_GET_METANAMES */
+    GS_COMMAND_GET_METANAME,                                                    /* GSAPI_GET_METANAME */
+    GS_COMMAND_GET_METAVALUE,                                                   /* GSAPI_GET_METAVALUE */
+    GS_COMMAND_SET_METAVALUE,                                                   /* GSAPI_SET_METAVALUE */
+    GS_COMMAND_GET_CURVESCOUNT,                                                 /* GSAPI_GET_CURVESCOUNT */
+    GS_COMMAND_GET_CURVENAMES,                                                  /* GSAPI_GET_CURVENAMES */
+    GS_COMMAND_GET_CURVENAME,                                                   /* GSAPI_GET_CURVENAME */
+    GS_COMMAND_GET_CURVEVALUE,                                                  /* GSAPI_GET_CURVEVALUE */
+    GS_COMMAND_SET_CURVEVALUE,                                                  /* GSAPI_SET_CURVEVALUE */
+    GS_COMMAND_PLAY,                                                            /* GSAPI_PLAY */
+    GS_COMMAND_STOP,                                                            /* GSAPI_STOP */
+    GS_COMMAND_IS_PLAYING,                                                      /* GSAPI_IS_PLAYING */
+    GS_COMMAND_IS_INFINITE,                                                     /* GSAPI_IS_INFINITE */
+    GS_COMMAND_IS_RANDOMIZED,                                                   /* GSAPI_IS_RANDOMIZED */
+    GS_COMMAND_ENABLE_EVENTS,                                                   /* GSAPI_ENABLE_EVENTS */
+    GS_COMMAND_WINDOW_BACK,                                                     /* GSAPI_WINDOW_BACK */
+    GS_COMMAND_WINDOW_FRONT,                                                    /* GSAPI_WINDOW_FRONT */
+    GS_COMMAND_WINDOW_MESSAGE,                                                  /* GSAPI_WINDOW_MESSAGE */
+    GS_COMMAND_WINDOW_PARAMETERS,                                               /* GSAPI_WINDOW_PARAMETERS */
+    GS_COMMAND_WINDOW_RENDERING,                                                /* GSAPI_WINDOW_RENDERING */
+    GS_COMMAND_WINDOW_TEST,                                                     /* GSAPI_WINDOW_TEST */
+    GS_COMMAND_COUNT                                                            /* コマンドの数 */
+} GsCommandId;
+
+/* 応答の種類 */
+typedef enum GsReplyTypeEnum {
+    GS_REPLY_NONE = 0,                                                          /* 応答を使わない */
+    GS_REPLY_TEXT,                                                              /* 文字列 */
+    GS_REPLY_LIST,                                                              /* カンマ区切りの文字列 */
+    GS_REPLY_FLOAT,                                                             /* 小数 */
+    GS_REPLY_COUNT,                                                             /* 個数 */
+    GS_REPLY_FLAG,                                                              /* 0または1 */
+    GS_REPLY_DRAWING,                                                           /* スケッチパッドの曲線 */
+    GS_REPLY_CURVEVALUE                                                         /* オートメーションカーブ */
+} GsReplyType;
+
+/* コマンドの記述子 */
+typedef struct GsCommandDescriptorStruct {
+    GsCommandId         id;                                                     /* 識別子 */
+    std::string_view    name;                                                   /* ツールに送るコマンド名 */
+    GsReplyType         reply;                                                  /* 応答の種類 */
+} GsCommandDescriptor;
+
+/* 対象をインデックスで指定する引数 (BY_INDEX index) */
+typedef struct GsByIndexStruct {
+    unsigned int        index;                                                  /* インデックス */
+} GsByIndex;
+
+/* 対象を名前で指定する引数 (BY_NAME name) */
+typedef struct GsByNameStruct {
+    std::string_view    name;                                                   /* 名前 */
+} GsByName;
+
+/* 対象を引用符で囲んだ名前で指定する引数 (BY_NAME "name") */
+typedef struct GsByQuotedNameStruct {
+    std::string_view    name;                                                   /* 名前 */
+} GsByQuotedName;
+
+/* 同じ位置に指定できる引数の型の候補 */
+template <typename... Types>
+struct GsArgOneOf {};
+
+/* コマンドの引数の型の並び(argsに順に並べる)。コマンドごとに下で特殊化する */
+template <GsCommandId Id>
+struct GsCommandSpec;
+
+/****************************************************************
+ * 定数定義
+ ****************************************************************/
+/* コマンドの一覧。コマンド名と応答の種類はここだけで定める */
+inline constexpr GsCommandDescriptor GSAPI_COMMAND_TABLE[GS_COMMAND_COUNT] = {
+    { GS_COMMAND_GET_VERSION, GSAPI_GET_VERSION, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_COMMANDS, GSAPI_GET_COMMANDS, GS_REPLY_LIST },
+    { GS_COMMAND_GET_MODELS, GSAPI_GET_MODELS, GS_REPLY_LIST },
+    { GS_COMMAND_SELECT_MODEL, GSAPI_SELECT_MODEL, GS_REPLY_NONE },
+    { GS_COMMAND_GET_PATH, GSAPI_GET_PATH, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_SAMPLERATE, GSAPI_GET_SAMPLERATE, GS_REPLY_TEXT },
+    { GS_COMMAND_SET_SAMPLERATE, GSAPI_SET_SAMPLERATE, GS_REPLY_NONE },
+    { GS_COMMAND_QUERY_PATCHNAMES, GSAPI_QUERY_PATCHNAMES, GS_REPLY_LIST },
+    { GS_COMMAND_QUERY_PATCH, GSAPI_QUERY_PATCH, GS_REPLY_NONE },
+    { GS_COMMAND_QUERY_CATEGORIES, GSAPI_QUERY_CATEGORIES, GS_REPLY_LIST },
+    { GS_COMMAND_QUERY_TAGS, GSAPI_QUERY_TAGS, GS_REPLY_LIST },
+    { GS_COMMAND_LOAD_PATCH, GSAPI_LOAD_PATCH, GS_REPLY_NONE },
+    { GS_COMMAND_SAVE_PATCH, GSAPI_SAVE_PATCH, GS_REPLY_NONE },
+    { GS_COMMAND_RENDER_PATCH, GSAPI_RENDER_PATCH, GS_REPLY_NONE },
+    { GS_COMMAND_GET_MODELNAME, GSAPI_GET_MODELNAME, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_PATCHNAME, GSAPI_GET_PATCHNAME, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_VARIATION, GSAPI_GET_VARIATION, GS_REPLY_FLOAT },
+    { GS_COMMAND_SET_VARIATION, GSAPI_SET_VARIATION, GS_REPLY_NONE },
+    { GS_COMMAND_GET_DRAWING, GSAPI_GET_DRAWING, GS_REPLY_DRAWING },
+    { GS_COMMAND_SET_DRAWING, GSAPI_SET_DRAWING, GS_REPLY_NONE },
+    { GS_COMMAND_GET_METACOUNT, GSAPI_GET_METACOUNT, GS_REPLY_COUNT },
+    { GS_COMMAND_GET_METANAMES, GSAPI_GET_METANAMES, GS_REPLY_LIST },
+    { GS_COMMAND_GET_METANAME, GSAPI_GET_METANAME, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_METAVALUE, GSAPI_GET_METAVALUE, GS_REPLY_FLOAT },
+    { GS_COMMAND_SET_METAVALUE, GSAPI_SET_METAVALUE, GS_REPLY_NONE },
+    { GS_COMMAND_GET_CURVESCOUNT, GSAPI_GET_CURVESCOUNT, GS_REPLY_COUNT },
+    { GS_COMMAND_GET_CURVENAMES, GSAPI_GET_CURVENAMES, GS_REPLY_LIST },
+    { GS_COMMAND_GET_CURVENAME, GSAPI_GET_CURVENAME, GS_REPLY_TEXT },
+    { GS_COMMAND_GET_CURVEVALUE, GSAPI_GET_CURVEVALUE, GS_REPLY_CURVEVALUE },
+    { GS_COMMAND_SET_CURVEVALUE, GSAPI_SET_CURVEVALUE, GS_REPLY_NONE },
+    { GS_COMMAND_PLAY, GSAPI_PLAY, GS_REPLY_NONE },
+    { GS_COMMAND_STOP, GSAPI_STOP, GS_REPLY_NONE },
+    { GS_COMMAND_IS_PLAYING, GSAPI_IS_PLAYING, GS_REPLY_FLAG },
+    { GS_COMMAND_IS_INFINITE, GSAPI_IS_INFINITE, GS_REPLY_FLAG },
+    { GS_COMMAND_IS_RANDOMIZED, GSAPI_IS_RANDOMIZED, GS_REPLY_FLAG },
+    { GS_COMMAND_ENABLE_EVENTS, GSAPI_ENABLE_EVENTS, GS_REPLY_NONE },
+    { GS_COMMAND_WINDOW_BACK, GSAPI_WINDOW_BACK, GS_REPLY_NONE },
+    { GS_COMMAND_WINDOW_FRONT, GSAPI_WINDOW_FRONT, GS_REPLY_NONE },
+    { GS_COMMAND_WINDOW_MESSAGE, GSAPI_WINDOW_MESSAGE, GS_REPLY_TEXT },
+    { GS_COMMAND_WINDOW_PARAMETERS, GSAPI_WINDOW_PARAMETERS, GS_REPLY_TEXT },
+    { GS_COMMAND_WINDOW_RENDERING, GSAPI_WINDOW_RENDERING, GS_REPLY_TEXT },
+    { GS_COMMAND_WINDOW_TEST, GSAPI_WINDOW_TEST, GS_REPLY_NONE },
+};
+
+/* コマンドの引数の型。GSAPI_COMMAND_TABLEと同じ順に並べる */
+template <> struct GsCommandSpec<GS_COMMAND_GET_VERSION> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_COMMANDS> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_MODELS> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SELECT_MODEL> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_PATH> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_SAMPLERATE> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SET_SAMPLERATE> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_QUERY_PATCHNAMES> { typedef std::tuple<std::string, bool, bool, bool> args; };
+template <> struct GsCommandSpec<GS_COMMAND_QUERY_PATCH> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_QUERY_CATEGORIES> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_QUERY_TAGS> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_LOAD_PATCH> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SAVE_PATCH> { typedef std::tuple<std::string> args; };
+template <> struct GsCommandSpec<GS_COMMAND_RENDER_PATCH> { typedef std::tuple<std::string, unsigned int, unsigned int, unsigned int> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_MODELNAME> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_PATCHNAME> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_VARIATION> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SET_VARIATION> { typedef std::tuple<float> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_DRAWING> { typedef std::tuple<unsigned int> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SET_DRAWING> { typedef std::tuple<GsArgOneOf<std::vector<GsDrawingData>, GsDrawingBuffer>> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_METACOUNT> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_METANAMES> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_METANAME> { typedef std::tuple<unsigned int> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_METAVALUE> { typedef std::tuple<GsArgOneOf<GsByIndex, GsByName>> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SET_METAVALUE> { typedef std::tuple<GsArgOneOf<GsByIndex, GsByName>, float> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_CURVESCOUNT> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_CURVENAMES> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_CURVENAME> { typedef std::tuple<unsigned int> args; };
+template <> struct GsCommandSpec<GS_COMMAND_GET_CURVEVALUE> { typedef std::tuple<GsArgOneOf<GsByIndex, GsByQuotedName>> args; };
+template <> struct GsCommandSpec<GS_COMMAND_SET_CURVEVALUE> {
+    typedef std::tuple<GsArgOneOf<GsByIndex, GsByQuotedName>, std::vector<GsCurvePoint>, float, bool> args;
+};
+template <> struct GsCommandSpec<GS_COMMAND_PLAY> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_STOP> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_IS_PLAYING> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_IS_INFINITE> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_IS_RANDOMIZED> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_ENABLE_EVENTS> { typedef std::tuple<bool> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_BACK> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_FRONT> { typedef std::tuple<> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_MESSAGE> { typedef std::tuple<std::string, GsWindowButton> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_PARAMETERS> { typedef std::tuple<std::vector<GsParameter>> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_RENDERING> { typedef std::tuple<bool, bool> args; };
+template <> struct GsCommandSpec<GS_COMMAND_WINDOW_TEST> { typedef std::tuple<> args; };
+
+/* 引数の型がGsCommandSpecの1つの位置に合うか */
+template <typename Arg, typename Expected>
+struct GsIsCommandArg : std::is_same<Arg, Expected> {};
+
+template <typename Arg, typename... Types>
+struct GsIsCommandArg<Arg, GsArgOneOf<Types...>> : std::disjunction<std::is_same<Arg, Types>...> {};
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+/**************************************************************************
+ * @brief   コマンドの記述子を取得する。
+ * @param   id : コマンドの識別子
+ * @return  記述子の参照
+ **************************************************************************/
+constexpr const GsCommandDescriptor& gsapi_command(const GsCommandId id)
+{
+    return GSAPI_COMMAND_TABLE[id];
+}
+
+/**************************************************************************
+ * @brief   コマンドの一覧が識別子の順に並び、コマンド名に空白がないか確かめる。
+ * @return  正しければtrueを返す。それ以外の場合にfalseを返す。
+ **************************************************************************/
+constexpr bool gsapi_is_valid_command_table()
+{
+    for (size_t i = 0; i < GS_COMMAND_COUNT; i++) {
+        const GsCommandDescriptor& descriptor = GSAPI_COMMAND_TABLE[i];
+        if ((static_cast<size_t>(descriptor.id) != i) || descriptor.name.empty()
+            || (descriptor.name.find(' ') != std::string_view::npos)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(gsapi_is_valid_command_table(), "GSAPI_COMMAND_TABLE must follow GsCommandId and names must not contain spaces");
+
+/**************************************************************************
+ * @brief   すべてのコマンドにGsCommandSpecがあるか確かめる。
+ * @return  あればtrueを返す。なければコンパイルできない。
+ **************************************************************************/
+template <size_t... Indices>
+constexpr bool gsapi_has_command_specs(std::index_sequence<Indices...>)
+{
+    return ((std::tuple_size_v<typename GsCommandSpec<static_cast<GsCommandId>(Indices)>::args> >= 0) && ...);
+}
+static_assert(gsapi_has_command_specs(std::make_index_sequence<GS_COMMAND_COUNT>()), "every command must have a GsCommandSpec");
+
+/**************************************************************************
+ * @brief   同じ数の引数の型が、位置ごとにGsCommandSpecの型に合うか確かめる。
+ * @return  すべて合えばtrueを返す。それ以外の場合にfalseを返す。
+ **************************************************************************/
+template <typename Expected, typename... Args, size_t... Indices>
+constexpr bool gsapi_is_command_args_at(std::index_sequence<Indices...>)
+{
+    return (GsIsCommandArg<Args, std::tuple_element_t<Indices, Expected>>::value && ...);
+}
+
+/**************************************************************************
+ * @brief   引数の型の並びが、GsCommandSpecで定めたコマンドの引数に合うか確かめる。
+ *          参照とconstは取り除いて比べる。
+ * @return  合えばtrueを返す。それ以外の場合にfalseを返す。
+ **************************************************************************/
+template <GsCommandId Id, typename... Args>
+constexpr bool gsapi_is_command_args()
+{
+    typedef typename GsCommandSpec<Id>::args expected_args;
+    if constexpr (sizeof...(Args) != std::tuple_size_v<expected_args>) {
+        return false;
+    } else {
+        return gsapi_is_command_args_at<expected_args, std::decay_t<Args>...>(std::index_sequence_for<Args...>());
+    }
+}
+
 #endif /* GSAPI_COMMANDS_H */
@@ -0,0 +1,129 @@
+﻿/****************************************************************
+ * @file    gsapi_connection.h
+ * @brief   ツールとのTCP接続を保持する
+ * @version 1.0.5
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_CONNECTION_H
+#define GSAPI_CONNECTION_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/****************************************************************
+ * 型定義
+ ****************************************************************/
+#if (_WIN32)
+typedef std::uintptr_t GsSocket;                                                /* ソケット(WinsockのSOCKETと同じ幅) */
+#else
+typedef int GsSocket;                                                           /* ソケット(ファイルディスクリプタ) */
+#endif
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+class gsapi_connection
+{
+public:
+    gsapi_connection();
+    ~gsapi_connection();
+    gsapi_connection(const gsapi_connection&) = delete;
+    gsapi_connection& operator=(const gsapi_connection&) = delete;
+
+    /**************************************************************************
+     * @brief   プロセス全体のソケット機能を初期化する。2回目以降は何もしない。
+     * @return  初期化済みであればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool startup();
+
+    /**************************************************************************
+     * @brief   接続先を設定する。接続先が変わった場合は現在の接続を閉じる。
+     * @param   ip_address : 接続先のIPアドレス
+     * @param   port_number : 接続先のポート番号
+     **************************************************************************/
+    void set_endpoint(const std::string& ip_address, const unsigned int port_number);
+
+    /**************************************************************************
+     * @brief   接続、送信、受信それぞれの期限を設定する。
+     * @param   connect_timeout_msec : 接続が完了するまでの期限 [ミリ秒]
+     * @param   send_timeout_msec : メッセージを送り終えるまでの期限 [ミリ秒]
+     * @param   receive_timeout_msec : 応答を受け取り終えるまでの期限 [ミリ秒]
+     **************************************************************************/
+    void set_timeout(const unsigned int connect_timeout_msec,
+        const unsigned int send_timeout_msec, const unsigned int receive_timeout_msec);
+
+    /**************************************************************************
+     * @brief   接続を閉じる。次のコマンド送信時に再接続する。
+     **************************************************************************/
+    void disconnect();
+
+    /**************************************************************************
+     * @brief   ツールと接続中か。
+     * @return  接続中であればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_connected() const;
+
+    /**************************************************************************
+     * @brief   接続を再利用してメッセージを送り、デリミタまでの応答を受け取る。
+     *          未接続または相手が切断していた場合は送信前に再接続する。
+     *          送信に失敗した場合は、再利用した接続で1バイトも送れていないときだけ送り直す。
+     *          期限までに応答が届かなければ、空の応答でtrueを返す。
+     * @param   message : 送信するメッセージの参照
+     * @param   delimiter : 応答の終端を表すデリミタ
+     * @param   response : 受信バッファ上の応答(デリミタを除く)。次の送受信まで有効。
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_command(const std::string& message, const std::string& delimiter, std::string_view& response);
+    /**************************************************************************
+     * @brief   send_commandと同じ。期限までに応答が届いたかも受け取る。
+     * @param   message : 送信するメッセージの参照
+     * @param   delimiter : 応答の終端を表すデリミタ
+     * @param   response : 受信バッファ上の応答(デリミタを除く)。次の送受信まで有効。
+     * @param   is_replied : デリミタまでの応答を受け取ればtrueを格納する参照
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_command(const std::string& message, const std::string& delimiter,
+        std::string_view& response, bool& is_replied);
+
+    /**************************************************************************
+     * @brief   複数のコマンドを続けて送り、応答を送信した順に受け取る。
+     * @param   messages : デリミタで区切られたコマンドを連結した送信データ
+     * @param   count : 送信データに含まれるコマンドの数
+     * @param   delimiter : 応答の終端を表すデリミタ
+     * @param   responses : 受信バッファ上の応答(デリミタを除く)の配列。次の送受信まで有効。
+     * @return  すべての応答を受け取ればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_pipeline(const std::string& messages, const size_t count,
+        const std::string& delimiter, std::vector<std::string_view>& responses);
+
+private:
+    bool connect_to_endpoint();
+    bool is_alive() const;
+    bool send_with_reconnect(const std::string& message);
+    bool send_message(const std::string& message, size_t& total_sent);
+    bool receive_message(const std::string& delimiter, size_t& offset, size_t& length);
+    int receive_some();
+    void close_socket();
+
+private:
+    GsSocket            sock;                                                   /* 接続中のソケット */
+    std::string         ip_address;                                             /* 接続先:IPアドレス */
+    unsigned int        port_number;                                            /* 接続先:ポート番号 */
+    unsigned int        connect_timeout_msec;                                   /* 期限:接続 [ミリ秒] */
+    unsigned int        send_timeout_msec;                                      /* 期限:送信 [ミリ秒] */
+    unsigned int        receive_timeout_msec;                                   /* 期限:受信 [ミリ秒] */
+    std::vector<char>   receive_buffer;                                         /* 受信バッファ(必要に応じて拡張し再利用する) */
+    size_t              receive_begin;                                          /* 未読データの先頭位置 */
+    size_t              receive_end;                                            /* 受信済みデータの末尾位置 */
+    std::vector<std::pair<size_t, size_t>> frames;                              /* パイプライン受信中の応答の位置と長さ */
+    std::mutex          mutex;                                                  /* 送受信の排他 */
+};
+
+#endif /* GSAPI_CONNECTION_H */
@@ -0,0 +1,471 @@
+﻿/****************************************************************
+ * @file    gsapi_coroutine.h
+ * @brief   GameSynth Tool APIをC++20のコルーチンから呼び出す
+ * @version 1.0.1
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_COROUTINE_H
+#define GSAPI_COROUTINE_H
+
+/* コルーチンに対応したコンパイラ(C++20)でのみ利用できる */
+#if defined(__cpp_impl_coroutine)
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_async_client.h"
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+/****************************************************************
+ * 型定義
+ ****************************************************************/
+/* コルーチンを再開する実行環境。受け取った関数を任意のスレッドで実行する */
+typedef std::function<void(std::function<void()>)> GsExecutor;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * gsapi_async_clientのコマンドをco_awaitで待つ。応答が届くとexecutorに
+ * 再開を依頼するので、コルーチンはI/Oスレッドではなくexecutorのスレッドで続きを実行する。
+ */
+template <typename T = void>
+class gsapi_awaitable
+{
+public:
+    typedef std::function<void(const GsCompletion<T>&)> GsStarter;              /* コマンドを送り、完了時にcompletionを呼ぶ */
+
+    gsapi_awaitable(GsStarter starter, GsExecutor executor)
+        : starter(std::move(starter))
+        , executor(std::move(executor))
+        , result()
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        /* 完了通知は送信中にも呼ばれうる。再開後に自身を参照しないよう、先に取り出しておく */
+        GsStarter start = std::move(starter);
+        GsExecutor resume_executor = executor;
+        start([this, handle, resume_executor](const GsAsyncResult<T>& async_result) {
+            result = async_result;
+            if (resume_executor) {
+                resume_executor([handle]() { handle.resume(); });
+            } else {
+                handle.resume();
+            }
+        });
+    }
+
+    GsAsyncResult<T> await_resume()
+    {
+        return std::move(result);
+    }
+
+private:
+    GsStarter           starter;                                                /* コマンドの送信 */
+    GsExecutor          executor;                                               /* 再開する実行環境 */
+    GsAsyncResult<T>    result;                                                 /* コマンドの結果 */
+};
+
+/*
+ * 呼び出し元が完了を待たない(投げっぱなしの)コルーチンの戻り値型。
+ * 最初のco_awaitまでは呼び出したスレッドで実行する。
+ */
+class gsapi_task
+{
+public:
+    struct promise_type {
+        gsapi_task get_return_object() noexcept { return gsapi_task(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/*
+ * gsapi_async_clientのコマンドをco_await可能にする。
+ * 引数はコマンドの送信までコピーして保持するので、一時オブジェクトを渡してもよい。
+ * 返したawaitableをco_awaitし終えるまで、このオブジェクトを破棄しないこと。
+ */
+class gsapi_coroutine_client
+{
+public:
+    /**************************************************************************
+     * @brief   コルーチン用のクライアントを作る。
+     * @param   client : コマンドを送る非同期クライアント。このオブジェクトより長く生存すること。
+     * @param   executor : コルーチンを再開する実行環境。空であればI/Oスレッドで再開する。
+     **************************************************************************/
+    gsapi_coroutine_client(gsapi_async_client& client, GsExecutor executor)
+        : client(client)
+        , executor(std::move(executor))
+    {
+    }
+
+    /* GameSynth Tool APIをco_awaitで利用する関数。引数と結果の意味はgsapi_async_clientの同名関数と同じ */
+
+    gsapi_awaitable<std::string> command_get_version()
+    {
+        return await_command<GS_COMMAND_GET_VERSION>([this](const auto& completion) {
+            client.command_get_version(completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_get_commands()
+    {
+        return await_command<GS_COMMAND_GET_COMMANDS>([this](const auto& completion) {
+            client.command_get_commands(completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_get_models()
+    {
+        return await_command<GS_COMMAND_GET_MODELS>([this](const auto& completion) {
+            client.command_get_models(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_select_model(const std::string& model_name)
+    {
+        return await_command<GS_COMMAND_SELECT_MODEL>([this, model_name](const auto& completion) {
+            client.command_select_model(model_name, completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_path(const std::string& path_name)
+    {
+        return await_command<GS_COMMAND_GET_PATH>([this, path_name](const auto& completion) {
+            client.command_get_path(path_name, completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_samplerate()
+    {
+        return await_command<GS_COMMAND_GET_SAMPLERATE>([this](const auto& completion) {
+            client.command_get_samplerate(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_samplerate(const std::string& samplerate)
+    {
+        return await_command<GS_COMMAND_SET_SAMPLERATE>([this, samplerate](const auto& completion) {
+            client.command_set_samplerate(samplerate, completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_query_patchnames(const std::string& text, const bool name, const bool category, const bool tags)
+    {
+        return await_command<GS_COMMAND_QUERY_PATCHNAMES>([this, text, name, category, tags](const auto& completion) {
+            client.command_query_patchnames(text, name, category, tags, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_query_patch(const std::string& patch_name)
+    {
+        return await_command<GS_COMMAND_QUERY_PATCH>([this, patch_name](const auto& completion) {
+            client.command_query_patch(patch_name, completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_query_categories()
+    {
+        return await_command<GS_COMMAND_QUERY_CATEGORIES>([this](const auto& completion) {
+            client.command_query_categories(completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_query_tags()
+    {
+        return await_command<GS_COMMAND_QUERY_TAGS>([this](const auto& completion) {
+            client.command_query_tags(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_load_patch(const std::string& file_path)
+    {
+        return await_command<GS_COMMAND_LOAD_PATCH>([this, file_path](const auto& completion) {
+            client.command_load_patch(file_path, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_save_patch(const std::string& file_path)
+    {
+        return await_command<GS_COMMAND_SAVE_PATCH>([this, file_path](const auto& completion) {
+            client.command_save_patch(file_path, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_render_patch(const std::string& file_path, const unsigned int depth, const unsigned int channel, const unsigned int duration)
+    {
+        return await_command<GS_COMMAND_RENDER_PATCH>([this, file_path, depth, channel, duration](const auto& completion) {
+            client.command_render_patch(file_path, depth, channel, duration, completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_modelname()
+    {
+        return await_command<GS_COMMAND_GET_MODELNAME>([this](const auto& completion) {
+            client.command_get_modelname(completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_patchname()
+    {
+        return await_command<GS_COMMAND_GET_PATCHNAME>([this](const auto& completion) {
+            client.command_get_patchname(completion);
+        });
+    }
+
+    gsapi_awaitable<float> command_get_variation()
+    {
+        return await_command<GS_COMMAND_GET_VARIATION>([this](const auto& completion) {
+            client.command_get_variation(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_variation(const float& variation)
+    {
+        return await_command<GS_COMMAND_SET_VARIATION>([this, variation](const auto& completion) {
+            client.command_set_variation(variation, completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<GsDrawingData>> command_get_drawing(const unsigned int index)
+    {
+        return await_command<GS_COMMAND_GET_DRAWING>([this, index](const auto& completion) {
+            client.command_get_drawing(index, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_drawing(const std::vector<GsDrawingData>& drawing_data)
+    {
+        return await_command<GS_COMMAND_SET_DRAWING>([this, drawing_data](const auto& completion) {
+            client.command_set_drawing(drawing_data, completion);
+        });
+    }
+
+    gsapi_awaitable<unsigned int> command_get_metacount()
+    {
+        return await_command<GS_COMMAND_GET_METACOUNT>([this](const auto& completion) {
+            client.command_get_metacount(completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_get_metanames()
+    {
+        return await_command<GS_COMMAND_GET_METANAMES>([this](const auto& completion) {
+            client.command_get_metanames(completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_metaname(const unsigned int& index)
+    {
+        return await_command<GS_COMMAND_GET_METANAME>([this, index](const auto& completion) {
+            client.command_get_metaname(index, completion);
+        });
+    }
+
+    gsapi_awaitable<float> command_get_metavalue(const unsigned int& index)
+    {
+        return await_command<GS_COMMAND_GET_METAVALUE>([this, index](const auto& completion) {
+            client.command_get_metavalue(index, completion);
+        });
+    }
+
+    gsapi_awaitable<float> command_get_metavalue(const std::string& name)
+    {
+        return await_command<GS_COMMAND_GET_METAVALUE>([this, name](const auto& completion) {
+            client.command_get_metavalue(name, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_metavalue(const unsigned int& index, const float& metavalue)
+    {
+        return await_command<GS_COMMAND_SET_METAVALUE>([this, index, metavalue](const auto& completion) {
+            client.command_set_metavalue(index, metavalue, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_metavalue(const std::string& name, const float& metavalue)
+    {
+        return await_command<GS_COMMAND_SET_METAVALUE>([this, name, metavalue](const auto& completion) {
+            client.command_set_metavalue(name, metavalue, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues)
+    {
+        return gsapi_awaitable<>([this, metavalues](const GsCompletion<>& completion) {
+            client.command_set_metavalues(metavalues, completion);
+        }, executor);
+    }
+
+    gsapi_awaitable<unsigned int> command_get_curvescount()
+    {
+        return await_command<GS_COMMAND_GET_CURVESCOUNT>([this](const auto& completion) {
+            client.command_get_curvescount(completion);
+        });
+    }
+
+    gsapi_awaitable<std::vector<std::string>> command_get_curvenames()
+    {
+        return await_command<GS_COMMAND_GET_CURVENAMES>([this](const auto& completion) {
+            client.command_get_curvenames(completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_get_curvename(const unsigned int& curve_index)
+    {
+        return await_command<GS_COMMAND_GET_CURVENAME>([this, curve_index](const auto& completion) {
+            client.command_get_curvename(curve_index, completion);
+        });
+    }
+
+    gsapi_awaitable<GsCurveValue> command_get_curvevalue(const unsigned int& curve_index)
+    {
+        return await_command<GS_COMMAND_GET_CURVEVALUE>([this, curve_index](const auto& completion) {
+            client.command_get_curvevalue(curve_index, completion);
+        });
+    }
+
+    gsapi_awaitable<GsCurveValue> command_get_curvevalue(const std::string& curve_name)
+    {
+        return await_command<GS_COMMAND_GET_CURVEVALUE>([this, curve_name](const auto& completion) {
+            client.command_get_curvevalue(curve_name, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value)
+    {
+        return await_command<GS_COMMAND_SET_CURVEVALUE>([this, curve_index, curve_value](const auto& completion) {
+            client.command_set_curvevalue(curve_index, curve_value, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value)
+    {
+        return await_command<GS_COMMAND_SET_CURVEVALUE>([this, curve_name, curve_value](const auto& completion) {
+            client.command_set_curvevalue(curve_name, curve_value, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values)
+    {
+        return gsapi_awaitable<>([this, curve_values](const GsCompletion<>& completion) {
+            client.command_set_curvevalues(curve_values, completion);
+        }, executor);
+    }
+
+    gsapi_awaitable<> command_play()
+    {
+        return await_command<GS_COMMAND_PLAY>([this](const auto& completion) {
+            client.command_play(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_stop()
+    {
+        return await_command<GS_COMMAND_STOP>([this](const auto& completion) {
+            client.command_stop(completion);
+        });
+    }
+
+    gsapi_awaitable<bool> command_is_playing()
+    {
+        return await_command<GS_COMMAND_IS_PLAYING>([this](const auto& completion) {
+            client.command_is_playing(completion);
+        });
+    }
+
+    gsapi_awaitable<bool> command_is_infinite()
+    {
+        return await_command<GS_COMMAND_IS_INFINITE>([this](const auto& completion) {
+            client.command_is_infinite(completion);
+        });
+    }
+
+    gsapi_awaitable<bool> command_is_randomized()
+    {
+        return await_command<GS_COMMAND_IS_RANDOMIZED>([this](const auto& completion) {
+            client.command_is_randomized(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_enable_events(const bool is_notification)
+    {
+        return await_command<GS_COMMAND_ENABLE_EVENTS>([this, is_notification](const auto& completion) {
+            client.command_enable_events(is_notification, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_window_back()
+    {
+        return await_command<GS_COMMAND_WINDOW_BACK>([this](const auto& completion) {
+            client.command_window_back(completion);
+        });
+    }
+
+    gsapi_awaitable<> command_window_front()
+    {
+        return await_command<GS_COMMAND_WINDOW_FRONT>([this](const auto& completion) {
+            client.command_window_front(completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_window_message(const std::string& message, const GsWindowButton& button)
+    {
+        return await_command<GS_COMMAND_WINDOW_MESSAGE>([this, message, button](const auto& completion) {
+            client.command_window_message(message, button, completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_window_parameters(const std::vector<GsParameter>& params)
+    {
+        return await_command<GS_COMMAND_WINDOW_PARAMETERS>([this, params](const auto& completion) {
+            client.command_window_parameters(params, completion);
+        });
+    }
+
+    gsapi_awaitable<std::string> command_window_rendering(const bool& show_duration, const bool& show_variations)
+    {
+        return await_command<GS_COMMAND_WINDOW_RENDERING>([this, show_duration, show_variations](const auto& completion) {
+            client.command_window_rendering(show_duration, show_variations, completion);
+        });
+    }
+
+    gsapi_awaitable<> command_window_test()
+    {
+        return await_command<GS_COMMAND_WINDOW_TEST>([this](const auto& completion) {
+            client.command_window_test(completion);
+        });
+    }
+
+private:
+    /**************************************************************************
+     * @brief   コマンドを送るawaitableを作る。値の型はGSAPI_COMMAND_TABLEの応答の種類で決まる。
+     * @param   starter : completionを受け取り、コマンドを送る関数
+     * @return  コマンドの結果を待つawaitable
+     **************************************************************************/
+    template <GsCommandId Id, typename Starter>
+    gsapi_awaitable<GsReplyValue<Id>> await_command(Starter starter)
+    {
+        return gsapi_awaitable<GsReplyValue<Id>>(std::move(starter), executor);
+    }
+
+private:
+    gsapi_async_client& client;                                                 /* コマンドを送る非同期クライアント */
+    GsExecutor          executor;                                               /* コルーチンを再開する実行環境 */
+};
+
+#endif /* defined(__cpp_impl_coroutine) */
+
+#endif /* GSAPI_COROUTINE_H */
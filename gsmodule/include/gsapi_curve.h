@@ -0,0 +1,46 @@
+﻿/****************************************************************
+ * @file    gsapi_curve.h
+ * @brief   オートメーションカーブの点を減らす
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_CURVE_H
+#define GSAPI_CURVE_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include <vector>
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * Ramer–Douglas–Peucker法で、曲線の形を保ったまま点を減らす。
+ * 誤差が最も大きい点から順に残すので、許容誤差と点の上限のどちらでも止められる。
+ */
+class gsapi_curve
+{
+public:
+    /**************************************************************************
+     * @brief   曲線の点を減らす。始点と終点は必ず残す。
+     * @param   source : 元の点の配列の参照
+     * @param   max_error : 許容誤差(残した線分と元の点の距離)。これ以下になれば止める。
+     * @param   max_points : 残す点の上限。0なら上限なし。2未満は2として扱う。
+     * @param   destination : 残した点を格納する配列の参照。sourceとは別にすること。
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool simplify(const std::vector<GsCurvePoint>& source, const float max_error,
+        const unsigned int max_points, std::vector<GsCurvePoint>& destination);
+    /**************************************************************************
+     * @brief   通信設定で点を減らすように指定されていれば、送信する曲線を作る。
+     * @param   curve_value : 送信したい曲線の参照
+     * @param   config : 通信設定の参照(curve_max_error, curve_max_points)
+     * @param   work : 点を減らした曲線を作る作業領域の参照
+     * @return  送信する曲線の参照(curve_valueかwork)
+     **************************************************************************/
+    static const GsCurveValue& prepare(const GsCurveValue& curve_value, const GsApiClientConfig& config, GsCurveValue& work);
+};
+
+#endif /* GSAPI_CURVE_H */
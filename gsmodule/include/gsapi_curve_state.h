@@ -0,0 +1,94 @@
+﻿/****************************************************************
+ * @file    gsapi_curve_state.h
+ * @brief   送信したオートメーションカーブを覚え、変わった曲線だけを送る
+ * @version 1.0.1
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_CURVE_STATE_H
+#define GSAPI_CURVE_STATE_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_session.h"
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * オートメーションカーブごとに最後に送った曲線を覚え、同じ曲線は送らない。
+ * stageで変更を溜め、flushで変わった曲線だけをパイプラインでまとめて送る。
+ * パッチを読み込み直したなど、ツール側の曲線が変わった場合はinvalidateで忘れること。
+ * セッションはこのインスタンスより先に破棄しないこと。
+ */
+class gsapi_curve_state
+{
+public:
+    /**************************************************************************
+     * @brief   送信に使うセッションを指定して作る。
+     * @param   session : セッションの参照
+     **************************************************************************/
+    explicit gsapi_curve_state(gsapi_session& session);
+    gsapi_curve_state(const gsapi_curve_state&) = delete;
+    gsapi_curve_state& operator=(const gsapi_curve_state&) = delete;
+
+    /**************************************************************************
+     * @brief   曲線の変更を溜める。最後に送った曲線と同じなら何もしない。
+     * @param   target : オートメーションカーブのインデックスまたは名前
+     * @param   curve_value : 設定したい曲線の参照
+     * @return  送る必要があればtrueを返す。送った曲線と同じ場合にfalseを返す。
+     **************************************************************************/
+    bool stage(const GsTarget& target, const GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   溜めた曲線のうち、変わったものだけをまとめて送る。
+     * @return  送れればtrueを返す(送るものがなければtrue)。それ以外の場合にfalseを返す。
+     *          通信に失敗した変更は溜めたままにし、送る前に失敗した変更(パッチにない名前など)は捨てる。
+     **************************************************************************/
+    bool flush();
+    /**************************************************************************
+     * @brief   曲線をすぐに送る。最後に送った曲線と同じなら送らない。
+     * @param   target : オートメーションカーブのインデックスまたは名前
+     * @param   curve_value : 設定したい曲線の参照
+     * @return  送れた、または送る必要がなければtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool command_set_curvevalue(const GsTarget& target, const GsCurveValue& curve_value);
+
+    /**************************************************************************
+     * @brief   送っていない変更の数を調べる。
+     * @return  溜めている曲線の数
+     **************************************************************************/
+    size_t dirty_count() const;
+    /**************************************************************************
+     * @brief   覚えている曲線と溜めた変更をすべて忘れる。次は同じ曲線でも送る。
+     **************************************************************************/
+    void invalidate();
+
+private:
+    /* オートメーションカーブごとの状態 */
+    typedef struct GsCurveStateEntryStruct {
+        GsCurveValue    sent;                                                   /* 最後に送った曲線 */
+        size_t          sent_hash = 0;                                          /* sentのハッシュ値 */
+        bool            is_sent = false;                                        /* sentが有効か */
+        GsCurveValue    pending;                                                /* 送っていない曲線 */
+        size_t          pending_hash = 0;                                       /* pendingのハッシュ値 */
+        bool            is_dirty = false;                                       /* pendingが有効か */
+    } GsCurveStateEntry;
+
+    static size_t hash(const GsCurveValue& curve_value);
+    static bool is_same(const GsCurveValue& left, const GsCurveValue& right);
+    bool is_sent(const GsCurveStateEntry& entry, const GsCurveValue& curve_value, const size_t value_hash) const;
+
+private:
+    gsapi_session&                          session;                            /* 送信に使うセッション */
+    std::map<GsTarget, GsCurveStateEntry>   entries;                            /* オートメーションカーブごとの状態 */
+    std::vector<GsCurveValueEntry>          flush_buffer;                       /* flushで送る曲線(容量を使い回す) */
+    std::vector<size_t>                     failed_indices;                     /* flushで送る前に失敗した曲線の位置(容量を使い回す) */
+    mutable std::mutex                      mutex;                              /* entriesの排他 */
+};
+
+#endif /* GSAPI_CURVE_STATE_H */
@@ -0,0 +1,138 @@
+﻿/****************************************************************
+ * @file    gsapi_drawing.h
+ * @brief   スケッチパッドの曲線を要素ごとの配列で保持し、まとめて加工する
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_DRAWING_H
+#define GSAPI_DRAWING_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSAPI_DRAWING_ALIGNMENT     (64)                                        /* 配列の先頭の境界 [バイト] (キャッシュライン、AVX-512の幅) */
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * GSAPI_DRAWING_ALIGNMENTの境界にそろえて確保するアロケータ。
+ */
+template<typename T>
+class gsapi_aligned_allocator
+{
+public:
+    typedef T value_type;
+
+    gsapi_aligned_allocator() noexcept = default;
+    template<typename U>
+    gsapi_aligned_allocator(const gsapi_aligned_allocator<U>&) noexcept {}
+
+    T* allocate(const size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(GSAPI_DRAWING_ALIGNMENT)));
+    }
+    void deallocate(T* pointer, const size_t) noexcept
+    {
+        ::operator delete(pointer, std::align_val_t(GSAPI_DRAWING_ALIGNMENT));
+    }
+
+    template<typename U>
+    bool operator==(const gsapi_aligned_allocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const gsapi_aligned_allocator<U>&) const noexcept { return false; }
+};
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 境界をそろえた小数の配列 */
+typedef std::vector<float, gsapi_aligned_allocator<float>> GsAlignedFloats;
+
+/* スケッチパッドの曲線を要素ごとの配列で格納する構造体。4つの配列は同じ長さにすること */
+typedef struct GsDrawingBufferStruct {
+    GsAlignedFloats t;                                                          /* 秒単位の時間 [0….60] */
+    GsAlignedFloats x;                                                          /* 水平位置 [0…1] */
+    GsAlignedFloats y;                                                          /* 垂直位置 [0…1] */
+    GsAlignedFloats p;                                                          /* 筆圧量[0…1] */
+} GsDrawingBuffer;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * GsDrawingBufferの変換と加工を行う。
+ * 加工は要素ごとの配列に対する単純なループで書き、コンパイラのベクトル化に任せる。
+ */
+class gsapi_drawing
+{
+public:
+    /**************************************************************************
+     * @brief   点の数を調べる。
+     * @param   buffer : 曲線の参照
+     * @return  点の数。配列の長さがそろっていなければ最も短い配列の長さ。
+     **************************************************************************/
+    static size_t size(const GsDrawingBuffer& buffer);
+    /**************************************************************************
+     * @brief   4つの配列の長さをそろえて変更する。
+     * @param   buffer : 曲線の参照
+     * @param   size : 点の数
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool resize(GsDrawingBuffer& buffer, const size_t size);
+    /**************************************************************************
+     * @brief   点の配列から要素ごとの配列に変換する。
+     * @param   drawing_data : 点の配列の参照
+     * @param   buffer : 変換した曲線を格納する参照
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool from_points(const std::vector<GsDrawingData>& drawing_data, GsDrawingBuffer& buffer);
+    /**************************************************************************
+     * @brief   要素ごとの配列から点の配列に変換する。
+     * @param   buffer : 曲線の参照
+     * @param   drawing_data : 変換した点を格納する配列の参照
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool to_points(const GsDrawingBuffer& buffer, std::vector<GsDrawingData>& drawing_data);
+
+    /**************************************************************************
+     * @brief   時間を t * scale + offset に変換する。
+     * @param   buffer : 曲線の参照
+     * @param   scale : 倍率
+     * @param   offset : 加える秒数
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool scale_time(GsDrawingBuffer& buffer, const float scale, const float offset);
+    /**************************************************************************
+     * @brief   時間を0秒始まりにし、水平位置と垂直位置をそれぞれ[0…1]に広げる。
+     *          幅のない方向は0.5にそろえる。
+     * @param   buffer : 曲線の参照
+     * @return  点があればtrueを返す。空の場合にfalseを返す。
+     **************************************************************************/
+    static bool normalize(GsDrawingBuffer& buffer);
+    /**************************************************************************
+     * @brief   筆圧量を[0…1]に収めてから p ^ gamma に変換する。
+     * @param   buffer : 曲線の参照
+     * @param   gamma : 指数。1より大きいと弱く、小さいと強くなる。
+     * @return  変換できればtrueを返す。gammaが0以下の場合にfalseを返す。
+     **************************************************************************/
+    static bool apply_pressure_curve(GsDrawingBuffer& buffer, const float gamma);
+    /**************************************************************************
+     * @brief   一定の間隔で点を取り直す。間の値は前後の点から直線で補間する。
+     * @param   source : 時間の昇順に並んだ曲線の参照
+     * @param   rate : 1秒あたりの点の数
+     * @param   destination : 取り直した曲線を格納する参照。sourceとは別にすること。
+     * @return  取り直せればtrueを返す。点がない、rateが0以下の場合にfalseを返す。
+     **************************************************************************/
+    static bool resample(const GsDrawingBuffer& source, const float rate, GsDrawingBuffer& destination);
+};
+
+#endif /* GSAPI_DRAWING_H */
@@ -0,0 +1,100 @@
+﻿/****************************************************************
+ * @file    gsapi_meta_coalescer.h
+ * @brief   メタパラメータの設定をまとめ、最新の値だけを一定の頻度で送る
+ * @version 1.0.1
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_META_COALESCER_H
+#define GSAPI_META_COALESCER_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_session.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSAPI_META_COALESCER_DEFAULT_RATE   (60)                                /* デフォルトの1秒あたりの送信回数の上限 */
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * ノブやMIDIコントローラーの入力の速さでメタパラメータを設定しても、
+ * メタパラメータごとに最新の値だけを残し、パイプラインでまとめて送る。
+ * startすると送信スレッドが1秒あたりrate回まで送るので、入力がどれだけ速くても
+ * 値がツールに届くまでの遅れは、おおむね1/rate秒と1回の送信時間に収まる。
+ * 通信に失敗した値は送り直すが、送り直す間隔は失敗が続くほど長くする。
+ * startしなければ、flushを呼んだときだけ送る。
+ * セッションはこのインスタンスより先に破棄しないこと。
+ */
+class gsapi_meta_coalescer
+{
+public:
+    /**************************************************************************
+     * @brief   送信に使うセッションを指定して作る。
+     * @param   session : セッションの参照
+     **************************************************************************/
+    explicit gsapi_meta_coalescer(gsapi_session& session);
+    ~gsapi_meta_coalescer();
+    gsapi_meta_coalescer(const gsapi_meta_coalescer&) = delete;
+    gsapi_meta_coalescer& operator=(const gsapi_meta_coalescer&) = delete;
+
+    /**************************************************************************
+     * @brief   送信スレッドを開始する。
+     * @param   rate : 1秒あたりの送信回数の上限
+     * @return  開始できればtrueを返す。既に開始している、rateが0の場合にfalseを返す。
+     **************************************************************************/
+    bool start(const unsigned int rate = GSAPI_META_COALESCER_DEFAULT_RATE);
+    /**************************************************************************
+     * @brief   送信スレッドを止め、残っている値を送る。
+     **************************************************************************/
+    void stop();
+
+    /**************************************************************************
+     * @brief   メタパラメータの値を設定する。送るまでに次の値が来れば、古い値は送らない。
+     * @param   target : メタパラメータのインデックスまたは名前
+     * @param   metavalue : 設定したい値
+     **************************************************************************/
+    void command_set_metavalue(const GsTarget& target, const float metavalue);
+    /**************************************************************************
+     * @brief   残っている値をすぐにまとめて送る。
+     * @return  送れればtrueを返す(送るものがなければtrue)。それ以外の場合にfalseを返す。
+     *          通信に失敗した値は(新しい値が来ていなければ)次に送り、
+     *          送る前に失敗した値(パッチにない名前など)は捨てる。
+     **************************************************************************/
+    bool flush();
+    /**************************************************************************
+     * @brief   送っていない値の数を調べる。
+     * @return  送っていないメタパラメータの数
+     **************************************************************************/
+    size_t pending_count() const;
+
+private:
+    bool send_pending(size_t& dropped_count);
+    void run();
+
+private:
+    gsapi_session&                  session;                                    /* 送信に使うセッション */
+    std::map<GsTarget, float>       pending;                                    /* メタパラメータごとの送っていない最新の値 */
+    mutable std::mutex              mutex;                                      /* pendingの排他 */
+    std::condition_variable         condition;                                  /* 値の到着と停止の通知 */
+    std::mutex                      send_mutex;                                 /* 送信の排他(古い値が後から届かないようにする) */
+    std::vector<GsMetaValueEntry>   send_values;                                /* 送信する値(send_mutexで保護し、容量を使い回す) */
+    std::vector<size_t>             failed_indices;                             /* 送る前に失敗した値の位置(send_mutexで保護し、容量を使い回す) */
+    std::thread                     flush_thread;                               /* 送信スレッド */
+    std::atomic<bool>               running;                                    /* 送信スレッドが動いているか */
+    std::chrono::steady_clock::duration interval;                               /* 送信の最短間隔 */
+};
+
+#endif /* GSAPI_META_COALESCER_H */
@@ -0,0 +1,158 @@
+﻿/****************************************************************
+ * @file    gsapi_pool.h
+ * @brief   複数のツールへの接続を保持し、貸し出す
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_POOL_H
+#define GSAPI_POOL_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_session.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSAPI_POOL_DEFAULT_CONNECTIONS_PER_ENDPOINT (1)                         /* デフォルトの接続先ごとの接続数 */
+#define GSAPI_POOL_DEFAULT_IDLE_CHECK_MSEC          (5000)                      /* デフォルトの未使用接続を確認する間隔 [ミリ秒] */
+#define GSAPI_POOL_DEFAULT_ACQUIRE_TIMEOUT_MSEC     (1000)                      /* デフォルトの貸し出しを待つ期限 [ミリ秒] */
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+
+/* 接続プールの設定 */
+typedef struct GsApiPoolConfigStruct {
+    std::vector<GsApiClientConfig> endpoints;                                   /* 接続先ごとの通信設定 */
+    unsigned int    connections_per_endpoint = GSAPI_POOL_DEFAULT_CONNECTIONS_PER_ENDPOINT; /* 接続先ごとの接続数 */
+    unsigned int    idle_check_msec      = GSAPI_POOL_DEFAULT_IDLE_CHECK_MSEC;  /* この時間使われなかった接続は貸し出す前に確認する [ミリ秒] */
+    unsigned int    acquire_timeout_msec = GSAPI_POOL_DEFAULT_ACQUIRE_TIMEOUT_MSEC; /* 空きの接続を待つ期限 [ミリ秒] */
+} GsApiPoolConfig;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+class gsapi_pool;
+
+/*
+ * プールから借りた接続。破棄すると接続をプールに返す。
+ */
+class gsapi_lease
+{
+public:
+    gsapi_lease();
+    ~gsapi_lease();
+    gsapi_lease(gsapi_lease&& other) noexcept;
+    gsapi_lease& operator=(gsapi_lease&& other) noexcept;
+    gsapi_lease(const gsapi_lease&) = delete;
+    gsapi_lease& operator=(const gsapi_lease&) = delete;
+
+    /**************************************************************************
+     * @brief   接続を借りているか。
+     * @return  借りていればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_valid() const;
+    /**************************************************************************
+     * @brief   借りている接続の接続先を調べる。
+     * @return  GsApiPoolConfig::endpointsでの接続先の番号
+     **************************************************************************/
+    size_t get_endpoint() const;
+    /**************************************************************************
+     * @brief   接続をプールに返す。
+     **************************************************************************/
+    void release();
+    /**************************************************************************
+     * @brief   接続に異常があったことを知らせてプールに返す。次に貸し出す前に確認する。
+     **************************************************************************/
+    void invalidate();
+
+    gsapi_session& operator*() const;
+    gsapi_session* operator->() const;
+
+private:
+    friend class gsapi_pool;
+    gsapi_lease(gsapi_pool* pool, const size_t index, gsapi_session* session, const size_t endpoint);
+
+private:
+    gsapi_pool*     pool;                                                       /* 貸し出したプール */
+    size_t          index;                                                      /* プール内の接続の番号 */
+    gsapi_session*  session;                                                    /* 借りている接続 */
+    size_t          endpoint;                                                   /* 接続先の番号 */
+};
+
+/*
+ * 接続先ごとに接続(gsapi_session)を保持し、空いている接続を貸し出す。
+ * 一定時間使われなかった接続は、is_connectと同じ空のコマンドで確認してから貸し出す。
+ * 貸し出した接続(gsapi_lease)は、プールより先に破棄すること。
+ */
+class gsapi_pool
+{
+public:
+    gsapi_pool();
+    ~gsapi_pool();
+    gsapi_pool(const gsapi_pool&) = delete;
+    gsapi_pool& operator=(const gsapi_pool&) = delete;
+
+    /**************************************************************************
+     * @brief   接続先ごとに接続を作り、接続しておく。
+     * @param   config : 接続プールの設定の参照
+     * @return  1つ以上の接続が使えればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool open(const GsApiPoolConfig& config);
+    /**************************************************************************
+     * @brief   すべての接続を閉じる。貸し出し中の接続があれば返却を待つ。
+     **************************************************************************/
+    void close();
+
+    /**************************************************************************
+     * @brief   いずれかの接続先の空いている接続を借りる。接続先は順番に選ぶ。
+     * @param   lease : 借りた接続を格納する参照
+     * @return  期限までに借りられればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool acquire(gsapi_lease& lease);
+    /**************************************************************************
+     * @brief   指定した接続先の空いている接続を借りる。
+     * @param   endpoint : GsApiPoolConfig::endpointsでの接続先の番号
+     * @param   lease : 借りた接続を格納する参照
+     * @return  期限までに借りられればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool acquire(const size_t endpoint, gsapi_lease& lease);
+
+    /**************************************************************************
+     * @brief   一定時間使われていない接続を確認する。
+     * @return  使える接続の数を返す。
+     **************************************************************************/
+    size_t check_idle();
+
+private:
+    /* プールが保持する接続 */
+    typedef struct GsPoolEntryStruct {
+        std::unique_ptr<gsapi_session> session;                                 /* 接続 */
+        size_t      endpoint = 0;                                               /* 接続先の番号 */
+        bool        is_leased = false;                                          /* 貸し出し中か */
+        bool        is_healthy = false;                                         /* 前回の確認で使えたか */
+        std::chrono::steady_clock::time_point last_checked;                     /* 最後に使えることを確認した(使われた)時刻 */
+    } GsPoolEntry;
+
+    friend class gsapi_lease;
+    bool acquire_from(const bool is_any, const size_t endpoint, gsapi_lease& lease);
+    void give_back(const size_t index, const bool is_healthy);
+    bool is_stale(const GsPoolEntry& entry, const std::chrono::steady_clock::time_point& now) const;
+
+private:
+    GsApiPoolConfig             config;                                         /* 接続プールの設定 */
+    std::vector<GsPoolEntry>    entries;                                        /* 保持している接続 */
+    size_t                      next_index;                                     /* 次に探し始める接続の番号 */
+    std::mutex                  mutex;                                          /* entriesの排他 */
+    std::condition_variable     condition;                                      /* 接続の返却通知 */
+};
+
+#endif /* GSAPI_POOL_H */
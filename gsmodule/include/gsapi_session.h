@@ -0,0 +1,615 @@
+﻿/****************************************************************
+ * @file    gsapi_session.h
+ * @brief   1つのツールとの通信設定と接続を持ち、GameSynth Tool APIを呼び出す
+ * @version 1.0.11
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_SESSION_H
+#define GSAPI_SESSION_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gsapi_client.h"
+#include "gsapi_connection.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <string_view>
+#include <vector>
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * 通信設定、接続、受信バッファ、パイプラインをインスタンスごとに持つ。
+ * ツールごとにセッションを作れば、複数のスレッドから並行して別々のツールを操作できる。
+ * 1つのセッションを複数のスレッドで共有した場合、コマンドは1つずつ順に処理する。
+ * gsapi_clientの静的関数は、既定のセッションに対する呼び出しと同じ。
+ */
+class gsapi_session
+{
+public:
+    gsapi_session();
+    /**************************************************************************
+     * @brief   通信設定を指定してセッションを作る。
+     * @param   config : 通信設定の参照
+     **************************************************************************/
+    explicit gsapi_session(const GsApiClientConfig& config);
+    gsapi_session(const gsapi_session&) = delete;
+    gsapi_session& operator=(const gsapi_session&) = delete;
+
+    /**************************************************************************
+     * @brief   ツールとの通信方法を更新する。
+     * @param   config : 新しい通信設定の参照
+     * @return  更新完了でtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool set_config(const GsApiClientConfig& config);
+    /**************************************************************************
+     * @brief   ツールとの通信方法を取得する。
+     * @param   config : 現在の通信設定を格納する参照
+     * @return  取得完了でtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool get_config(GsApiClientConfig& config);
+
+    /**************************************************************************
+     * @brief   起動中のツールに対してメッセージを送る。
+     * @param   message : 送信するメッセージの参照
+     * @param   response : 受信するメッセージを格納する参照
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_command(const std::string& message, std::string& response);
+
+    /**************************************************************************
+     * @brief   ツールとTCP通信できるか。
+     * @return  通信可能であればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_connect();
+    /**************************************************************************
+     * @brief   覚えているパッチの情報を捨てる。次の取得はツールに問い合わせる。
+     *          command_load_patch、command_query_patch、command_select_model、set_configでは自動で捨てる。
+     *          send_commandでパッチを切り替えた場合は、これを呼ぶこと。
+     **************************************************************************/
+    void invalidate_mirror();
+
+    /**************************************************************************
+     * @brief   パイプラインを開始する。end_pipelineを呼ぶまで、各コマンドは送信せずに
+     *          蓄積し、応答を待たずにtrueを返す。取得系コマンドも蓄積するが、値を受け取れない
+     *          のでfalseを返す。応答はend_pipelineで送信した順に受け取る。
+     *          end_pipelineまでは他のスレッドのコマンドを待たせるので、
+     *          begin_pipelineとend_pipelineは同じスレッドから呼ぶこと。
+     * @return  開始できればtrueを返す。既にパイプライン中ならfalseを返す。
+     **************************************************************************/
+    bool begin_pipeline();
+    /**************************************************************************
+     * @brief   蓄積したコマンドを1つの接続で続けて送信し、すべての応答を待つ。
+     * @return  すべての応答を受け取ればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool end_pipeline();
+    /**************************************************************************
+     * @brief   蓄積したコマンドを1つの接続で続けて送信し、応答を送信した順に受け取る。
+     * @param   responses : 応答(デリミタを除く)を格納する配列の参照
+     * @return  すべての応答を受け取ればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool end_pipeline(std::vector<std::string>& responses);
+
+public:
+    /* GameSynth Tool APIを利用する関数 */
+
+    /**************************************************************************
+     * @brief   バージョンを調べる。
+     * @param   version : ツールバージョンを格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_version(std::string& version);
+    /**************************************************************************
+     * @brief   利用可能なコマンドを調べる。
+     * @param   commmand_list : コマンド一覧を格納する配列の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_commands(std::vector<std::string>& commmand_list);
+    /**************************************************************************
+     * @brief   利用可能なコマンドを調べる。
+     * @param   commmand_list : コマンド一覧を格納する配列の参照。
+     *          受信バッファ上の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_commands(std::vector<std::string_view>& commmand_list);
+    /**************************************************************************
+     * @brief   利用可能なモデルを調べる。
+     * @param   model_list : モデル一覧を格納する配列の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_models(std::vector<std::string>& model_list);
+    /**************************************************************************
+     * @brief   利用可能なモデルを調べる。
+     * @param   model_list : モデル一覧を格納する配列の参照。
+     *          受信バッファ上の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_models(std::vector<std::string_view>& model_list);
+    /**************************************************************************
+     * @brief   名前で指定したモデルをツール上で選択する。
+     * @param   model_name : モデル名を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_select_model(const std::string& model_name);
+    /**************************************************************************
+     * @brief   ツールのシステムパスを取得する。
+     * @param   path_name : システムパスの名称
+     * @param   path_value : パスを格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_path(const std::string& path_name, std::string& path_value);
+    /**************************************************************************
+     * @brief   ツールのサンプリング周波数を取得する。
+     * @param   samplerate : ツールに設定された値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_samplerate(std::string& samplerate);
+    /**************************************************************************
+     * @brief   ツールにサンプリング周波数を設定する。
+     * @param   samplerate : ツールに設定する数値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_samplerate(const std::string& samplerate);
+
+    /**************************************************************************
+     * @brief   リポジトリから一致するパッチ名を返す。
+     * @param   text : 検索したい文字列
+     * @param   name : パッチ名の検索を有効にする
+     * @param   category : カテゴリ名の検索を有効にする
+     * @param   tags : タグ名の検索を有効にする
+     * @param   patch_list : パッチ名一覧を格納する配列の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_patchnames(const std::string& text, const bool name,
+        const bool category, const bool tags, std::vector<std::string>& patch_list);
+    /**************************************************************************
+     * @brief   リポジトリから一致するパッチ名を返す。
+     * @param   text : 検索したい文字列
+     * @param   name : パッチ名の検索を有効にする
+     * @param   category : カテゴリ名の検索を有効にする
+     * @param   tags : タグ名の検索を有効にする
+     * @param   patch_list : パッチ名一覧を格納する配列の参照。
+     *          受信バッファ上の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_patchnames(const std::string& text, const bool name,
+        const bool category, const bool tags, std::vector<std::string_view>& patch_list);
+    /**************************************************************************
+     * @brief   リポジトリからパッチを取得し、ツール上で読み込む。
+     * @param   patch_name : リポジトリから取得するパッチ名の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_patch(const std::string& patch_name);
+    /**************************************************************************
+     * @brief   リポジトリからカテゴリ一覧を取得する。
+     * @param   categoryt_list : カテゴリ一覧を格納する配列の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_categories(std::vector<std::string>& categoryt_list);
+    /**************************************************************************
+     * @brief   リポジトリからカテゴリ一覧を取得する。
+     * @param   categoryt_list : カテゴリ一覧を格納する配列の参照。
+     *          受信バッファ上の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_categories(std::vector<std::string_view>& categoryt_list);
+    /**************************************************************************
+     * @brief   リポジトリからタグ一覧を取得する。
+     * @param   tag_list : タグ一覧を格納する配列の参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_tags(std::vector<std::string>& tag_list);
+    /**************************************************************************
+     * @brief   リポジトリからタグ一覧を取得する。
+     * @param   tag_list : タグ一覧を格納する配列の参照。
+     *          受信バッファ上の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_query_tags(std::vector<std::string_view>& tag_list);
+
+    /**************************************************************************
+     * @brief   ファイルパスにあるパッチファイルをツール上で開く。
+     * @param   file_path : パッチファイルのパスの参照
+     * @return  GameSynthから応答があればtrueを返す。それ以外はfalseを返す
+     **************************************************************************/
+    bool command_load_patch(const std::string& file_path);
+    /**************************************************************************
+     * @brief   パッチをファイルパスに保存する。
+     * @param   file_path : パッチファイルのパスの参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_save_patch(const std::string& file_path);
+    /**************************************************************************
+     * @brief   パッチをファイルパスにレンダリングする。
+     * @param   file_path : 音源ファイルのパスの参照
+     * @param   depth : ビット深度
+     * @param   channel : チャンネル数
+     * @param   duration : デュレーション
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_render_patch(const std::string& file_path, const unsigned int depth,
+        const unsigned int channel, const unsigned int duration);
+    /**************************************************************************
+     * @brief   パッチのモデル名を取得する。
+     * @param   model_name : モデル名を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_modelname(std::string& model_name);
+    /**************************************************************************
+     * @brief   パッチのパッチ名を取得する。
+     * @param   patch_name : パッチ名を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_patchname(std::string& patch_name);
+    /**************************************************************************
+     * @brief   パッチのバリエーションを取得する。
+     * @param   variation : パッチのに設定された値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_variation(float& variation);
+    /**************************************************************************
+     * @brief   パッチにバリエーションを設定する。
+     * @param   variation : パッチに設定したい値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_variation(const float& variation);
+    /**************************************************************************
+     * @brief   パッチに設定された曲線を取得する。
+     * @param   index : パッチに設定された曲線の番号
+     * @param   drawing_data : パッチに設定された曲線の情報を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_drawing(const unsigned int index, std::vector<GsDrawingData>& drawing_data);
+    /**************************************************************************
+     * @brief   パッチに設定された曲線を要素ごとの配列で取得する。
+     * @param   index : パッチに設定された曲線の番号
+     * @param   drawing_buffer : パッチに設定された曲線の情報を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_drawing(const unsigned int index, GsDrawingBuffer& drawing_buffer);
+    /**************************************************************************
+     * @brief   パッチに曲線を設定する。
+     * @param   drawing_data : パッチに設定したい曲線の情報への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_drawing(const std::vector<GsDrawingData>& drawing_data);
+    /**************************************************************************
+     * @brief   要素ごとの配列で持つ曲線をパッチに設定する。
+     * @param   drawing_buffer : パッチに設定したい曲線の情報への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_drawing(const GsDrawingBuffer& drawing_buffer);
+
+    /**************************************************************************
+     * @brief   パッチのメタパラメータ数を取得する。
+     * @param   meta_count : メタパラメータ数を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_metacount(unsigned int& meta_count);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータの一覧を取得する。
+     * @param   meta_names : メタパラメータの一覧を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_metanames(std::vector<std::string>& meta_names);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータの一覧を取得する。
+     * @param   meta_names : メタパラメータの一覧を格納する参照。
+     *          受信バッファ(mirror_cacheが有効なら覚えている一覧)の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_metanames(std::vector<std::string_view>& meta_names);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータの名前を取得する。
+     * @param   index : メタパラメータのインデックスの数値
+     * @param   metaname : メタパラメータの名前を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_metaname(const unsigned int& index, std::string& metaname);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータの値を取得する。
+     * @param   index : メタパラメータのインデックスの数値
+     * @param   metavalue : ツールから返されたメタパラメータの数値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_metavalue(const unsigned int& index, float& metavalue);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータの値を取得する。
+     * @param   name : メタパラメータの名前
+     * @param   metavalue : ツールから返されたメタパラメータの数値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     *          resolve_namesが有効なら、インデックス指定に変換して送る。パッチにない名前は送らずにfalseを返す。
+     **************************************************************************/
+    bool command_get_metavalue(const std::string& name, float& metavalue);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータに値を設定する。
+     * @param   index : メタパラメータのインデックスの数値
+     * @param   metavalue : ツールに設定したいメタパラメータの数値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_metavalue(const unsigned int& index, const float& metavalue);
+    /**************************************************************************
+     * @brief   パッチのメタパラメータに値を設定する。
+     * @param   name : メタパラメータの名前
+     * @param   metavalue : ツールに設定したいメタパラメータの数値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     *          resolve_namesが有効なら、インデックス指定に変換して送る。パッチにない名前は送らずにfalseを返す。
+     **************************************************************************/
+    bool command_set_metavalue(const std::string& name, const float& metavalue);
+    /**************************************************************************
+     * @brief   パッチの複数のメタパラメータに値をまとめて設定する。
+     *          すべてのコマンドを1回の書き込みで送り、応答をまとめて待つ。
+     * @param   metavalues : 設定先と値の組の配列への参照
+     * @return  すべての値を送り、すべての応答があればtrueを返す。
+     *          送れない値(パッチにない名前など)があればfalseを返す。残りの値は送る。
+     **************************************************************************/
+    bool command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues);
+    /**************************************************************************
+     * @brief   command_set_metavaluesと同じ。送る前に失敗した値の位置も受け取る。
+     * @param   metavalues : 設定先と値の組の配列への参照
+     * @param   failed_indices : 送らなかった値(パッチにない名前、作成できないメッセージ)の
+     *          metavaluesでの位置を昇順に格納する配列の参照
+     * @return  残りの値を送り、すべての応答があればtrueを返す(送るものがなければtrue)。
+     *          通信に失敗した場合にfalseを返す。
+     **************************************************************************/
+    bool command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues, std::vector<size_t>& failed_indices);
+
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブ数を取得する。
+     * @param   curves_count : オートメーションカーブ数を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_curvescount(unsigned int& curves_count);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブの一覧を取得する。
+     * @param   curve_names : オートメーションカーブの一覧を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_curvenames(std::vector<std::string>& curve_names);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブの一覧を取得する。
+     * @param   curve_names : オートメーションカーブの一覧を格納する参照。
+     *          受信バッファ(mirror_cacheが有効なら覚えている一覧)の文字列を指すので、このセッションで次のコマンドを送るまで有効。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_curvenames(std::vector<std::string_view>& curve_names);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブの名前を取得する。
+     * @param   curve_index : オートメーションカーブのインデックスの数値
+     * @param   curve_name : オートメーションカーブの名前を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_curvename(const unsigned int& curve_index, std::string& curve_name);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブの値を取得する。
+     * @param   curve_index : オートメーションカーブのインデックスの数値
+     * @param   curve_value : オートーメーションカーブの値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_get_curvevalue(const unsigned int& curve_index, GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブの値を取得する。
+     * @param   curve_name : オートメーションカーブの名前への参照
+     * @param   curve_value : オートーメーションカーブの値を格納する参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     *          resolve_namesが有効なら、インデックス指定に変換して送る。パッチにない名前は送らずにfalseを返す。
+     **************************************************************************/
+    bool command_get_curvevalue(const std::string& curve_name, GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブに値を設定する。
+     * @param   curve_index : オートメーションカーブのインデックスの数値
+     * @param   curve_value : オートーメーションカーブの値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   パッチのオートメーションカーブに値を設定する。
+     * @param   curve_name : オートメーションカーブの名前への参照
+     * @param   curve_value : オートーメーションカーブの値への参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     *          resolve_namesが有効なら、インデックス指定に変換して送る。パッチにない名前は送らずにfalseを返す。
+     **************************************************************************/
+    bool command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value);
+    /**************************************************************************
+     * @brief   パッチの複数のオートメーションカーブに値をまとめて設定する。
+     *          すべてのコマンドを1回の書き込みで送り、応答をまとめて待つ。
+     * @param   curve_values : 設定先と曲線の組の配列への参照
+     * @return  すべての値を送り、すべての応答があればtrueを返す。
+     *          送れない値(パッチにない名前など)があればfalseを返す。残りの値は送る。
+     **************************************************************************/
+    bool command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values);
+    /**************************************************************************
+     * @brief   command_set_curvevaluesと同じ。送る前に失敗した曲線の位置も受け取る。
+     * @param   curve_values : 設定先と曲線の組の配列への参照
+     * @param   failed_indices : 送らなかった曲線(パッチにない名前、作成できないメッセージ)の
+     *          curve_valuesでの位置を昇順に格納する配列の参照
+     * @return  残りの曲線を送り、すべての応答があればtrueを返す(送るものがなければtrue)。
+     *          通信に失敗した場合にfalseを返す。
+     **************************************************************************/
+    bool command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values, std::vector<size_t>& failed_indices);
+
+    /**************************************************************************
+     * @brief   パッチを再生する。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_play();
+    /**************************************************************************
+     * @brief   パッチを停止する。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_stop();
+    /**************************************************************************
+     * @brief   パッチは再生中か調べる。
+     * @param   is_playing :　再生中なら[1]。それ以外なら[0]。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_is_playing(bool& is_playing);
+    /**************************************************************************
+     * @brief   パッチは再生時間が無限か調べる。
+     * @param   is_infinite :　時間が無限なら[1]。自動的に終了するなら[0]。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_is_infinite(bool& is_infinite);
+    /**************************************************************************
+     * @brief   パッチはランダム性があるか調べる。
+     * @param   is_randomized :　ランダム性があれば[1]。見つからなければ[0]。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_is_randomized(bool& is_randomized);
+    /**************************************************************************
+     * @brief   ツールの合成イベントの通知を設定する。
+     * @param   is_notification :　通知を有効なら[1]。通知を無効なら[0]。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_enable_events(const bool is_notification);
+
+    /**************************************************************************
+     * @brief   ツールのメインウィンドウを背面に移動する。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_back();
+    /**************************************************************************
+     * @brief   ツールのメインウィンドウを前面に移動する。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_front();
+    /**************************************************************************
+     * @brief   ツールのメッセージダイアログを表示する。
+     * @param   message :　ダイアログに表示する文字列の参照
+     * @param   button :　ダイアログに表示するボタンの組
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_message(const std::string& message, const GsWindowButton& button);
+    /**************************************************************************
+     * @brief   ツールのパラメーター設定ダイアログを表示する。
+     * @param   params :　ダイアログに表示するパラメーターへの参照
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_parameters(const std::vector<GsParameter>& params);
+    /**************************************************************************
+     * @brief   ツールのレンダリング設定ダイアログを表示する。
+     * @param   show_duration :　パッチのレンダリング時間を表示するなら[1]。非表示なら[0]。
+     * @param   show_variations :　パッチのバリエーション数を表示するなら[1]。非表示なら[0]。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_rendering(const bool& show_duration, const bool& show_variations);
+    /**************************************************************************
+     * @brief   ツールのテスト用ダイアログを表示する。
+     * @return  ツールから応答があればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool command_window_test();
+
+
+private:
+    /**************************************************************************
+     * @brief   起動中のツールに対してメッセージを送り、応答を受信バッファ上で受け取る。
+     * @param   message : 送信するメッセージの参照
+     * @param   response : 受信した応答(デリミタを除く)。次のコマンド送信まで有効。
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_command(const std::string& message, std::string_view& response);
+    /**************************************************************************
+     * @brief   send_commandと同じ。期限までに応答が届いたかも受け取る。
+     * @param   message : 送信するメッセージの参照
+     * @param   response : 受信した応答(デリミタを除く)。次のコマンド送信まで有効。
+     * @param   is_replied : デリミタまでの応答を受け取ればtrueを格納する参照
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_command(const std::string& message, std::string_view& response, bool& is_replied);
+    /**************************************************************************
+     * @brief   取得系コマンドを送り、応答を受信バッファ上で受け取る。
+     *          パイプライン中は蓄積だけして、値を受け取れないのでfalseを返す。
+     * @param   message : 送信するメッセージの参照
+     * @param   response : 受信した応答(デリミタを除く)。次のコマンド送信まで有効。
+     * @return  応答を受け取ればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_query(const std::string& message, std::string_view& response);
+    /**************************************************************************
+     * @brief   send_queryと同じ。期限までに応答が届いたかも受け取る。
+     * @param   message : 送信するメッセージの参照
+     * @param   response : 受信した応答(デリミタを除く)。次のコマンド送信まで有効。
+     * @param   is_replied : デリミタまでの応答を受け取ればtrueを格納する参照
+     * @return  応答を受け取ればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool send_query(const std::string& message, std::string_view& response, bool& is_replied);
+    /**************************************************************************
+     * @brief   メタパラメータかオートメーションカーブの一覧を問い合わせる。
+     * @param   is_curve : オートメーションカーブならtrue、メタパラメータならfalse
+     * @param   names : 一覧を格納する配列の参照(前の要素は消す)
+     * @param   is_replied : デリミタまでの応答を受け取ればtrueを格納する参照
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool query_names(const bool is_curve, std::vector<std::string>& names, bool& is_replied);
+    /**************************************************************************
+     * @brief   一覧を問い合わせて覚える。応答が届かなかった一覧は覚えない。
+     * @param   is_curve : オートメーションカーブならtrue、メタパラメータならfalse
+     * @return  ツールにメッセージを送信できればtrueを返す。それ以外はfalseを返す。
+     **************************************************************************/
+    bool mirror_names(const bool is_curve);
+    /**************************************************************************
+     * @brief   蓄積したコマンドを送信し、応答を受信バッファ上で受け取る。
+     * @param   responses : 受信した応答の配列。次のコマンド送信まで有効。
+     * @return  すべての応答を受け取ればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool end_pipeline(std::vector<std::string_view>& responses);
+    /**************************************************************************
+     * @brief   パッチの情報を覚えるか。通信設定で有効にしていて、パイプライン中でなければ覚える。
+     * @return  覚える場合にtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_mirroring() const;
+
+    /* 名前の変換結果 */
+    typedef enum GsResolveResultEnum {
+        GS_RESOLVE_INDEX = 0,                                                   /* インデックスに変換できた */
+        GS_RESOLVE_UNKNOWN,                                                     /* パッチにない名前 */
+        GS_RESOLVE_NAME,                                                        /* 変換しない(名前のまま送る) */
+    } GsResolveResult;
+
+    /**************************************************************************
+     * @brief   メタパラメータやオートメーションカーブの名前をインデックスに変換する(resolve_names)。
+     *          パッチごとに最初の1回だけ名前の一覧を取得し、名前からインデックスを引く表を作る。
+     * @param   is_curve : オートメーションカーブならtrue、メタパラメータならfalse
+     * @param   name : 名前の参照
+     * @param   index : 変換したインデックスを格納する参照
+     * @return  変換の結果。無効、パイプライン中で表がない、一覧を取得できないか空の場合はGS_RESOLVE_NAME。
+     **************************************************************************/
+    GsResolveResult resolve_name(const bool is_curve, const std::string& name, unsigned int& index);
+
+private:
+    /* 読み込み中のパッチについて覚えている情報(mirror_cache, resolve_names) */
+    typedef struct GsSessionMirrorStruct {
+        bool                        has_meta_count = false;                     /* meta_countが有効か */
+        unsigned int                meta_count = 0;                             /* メタパラメータ数 */
+        bool                        has_meta_names = false;                     /* meta_namesが有効か */
+        std::vector<std::string>    meta_names;                                 /* メタパラメータの一覧 */
+        bool                        has_curves_count = false;                   /* curves_countが有効か */
+        unsigned int                curves_count = 0;                           /* オートメーションカーブ数 */
+        bool                        has_curve_names = false;                    /* curve_namesが有効か */
+        std::vector<std::string>    curve_names;                                /* オートメーションカーブの一覧 */
+        bool                        has_model_name = false;                     /* model_nameが有効か */
+        std::string                 model_name;                                 /* モデル名 */
+        bool                        has_patch_name = false;                     /* patch_nameが有効か */
+        std::string                 patch_name;                                 /* パッチ名 */
+        bool                        has_meta_indices = false;                   /* meta_indicesが有効か */
+        std::unordered_map<std::string, unsigned int> meta_indices;             /* メタパラメータの名前からインデックスを引く表 */
+        bool                        has_curve_indices = false;                  /* curve_indicesが有効か */
+        std::unordered_map<std::string, unsigned int> curve_indices;            /* オートメーションカーブの名前からインデックスを引く表 */
+    } GsSessionMirror;
+
+private:
+    GsApiClientConfig       config;                                             /* 通信設定 */
+    gsapi_connection        connection;                                         /* ツールとの接続 */
+    bool                    pipelining;                                         /* パイプライン中か */
+    std::string             pipeline_messages;                                  /* パイプラインで蓄積した送信データ */
+    size_t                  pipeline_count;                                     /* パイプラインで蓄積したコマンド数 */
+    std::vector<std::string_view> pipeline_responses;                           /* 応答を使わないパイプラインの応答(容量を使い回す) */
+    std::string             send_buffer;                                        /* 送信メッセージの作成先(容量を使い回す) */
+    GsCurveValue            curve_buffer;                                       /* 点を減らしたオートメーションカーブの作成先(容量を使い回す) */
+    GsSessionMirror         mirror;                                             /* 覚えているパッチの情報 */
+    std::recursive_mutex    mutex;                                              /* コマンドの送信から応答の解析までの排他 */
+};
+
+#endif /* GSAPI_SESSION_H */
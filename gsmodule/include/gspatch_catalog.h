@@ -0,0 +1,114 @@
+﻿/****************************************************************
+ * @file    gspatch_catalog.h
+ * @brief   読み込んだgspatchファイルの一覧をファイルに保存し、変わったファイルだけを読み直す
+ * @version 1.0.2
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSPATCH_CATALOG_H
+#define GSPATCH_CATALOG_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gspatch_file.h"
+#include "gspatch_scanner.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSPATCH_CATALOG_MAGIC       "GSCATLOG"                                  /* 一覧ファイルの先頭の8文字 */
+#define GSPATCH_CATALOG_VERSION     (2)                                         /* 一覧ファイルの形式のバージョン */
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 一覧の1ファイル分 */
+typedef struct GsCatalogEntryStruct {
+    GameSynthPatchView  data;                                                   /* gspatchファイルのヘッダー(一覧ファイルか読み直した値を指す) */
+    uint64_t            file_size       = 0;                                    /* 読んだときの大きさ [バイト] */
+    int64_t             modified_time   = 0;                                    /* 読んだときの更新時刻(UNIX時刻からのナノ秒) */
+    bool                is_parsed       = false;                                /* 読めたか(読めなかったファイルも、変わるまで読み直さない) */
+} GsCatalogEntry;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * パッチライブラリのgspatchファイルのヘッダーを、ファイルパスの順に保持する。
+ * 一覧ファイルは固定長のレコードと文字列領域からなるバイナリ形式で、メモリに割り当てて読む。
+ *   ヘッダー   : 先頭の8文字、バイト順の確認値、形式のバージョン、レコード数、文字列領域の大きさ
+ *   レコード   : 大きさ、更新時刻、読めたか、7つの文字列の位置と長さ
+ *                更新時刻は標準ライブラリによらず、UNIX時刻(1970-01-01 UTC)からのナノ秒で持つ
+ *   文字列領域 : レコードの文字列を詰めたもの
+ * バイト順や形式のバージョンが違う一覧ファイルは読まない(すべて読み直す)。
+ * loadした一覧ファイルは割り当てたままにし、一覧の文字列は文字列領域を直接指す。
+ * updateで読み直したファイルの値だけを、アリーナに複製して持つ。
+ */
+class gspatch_catalog
+{
+public:
+    gspatch_catalog();
+    gspatch_catalog(const gspatch_catalog&) = delete;
+    gspatch_catalog& operator=(const gspatch_catalog&) = delete;
+
+    /**************************************************************************
+     * @brief   一覧ファイルを読む。読めなければ一覧は空になる。
+     * @param   catalog_path : 一覧ファイルのパス
+     * @return  読めればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool load(const std::string& catalog_path);
+    /**************************************************************************
+     * @brief   一覧ファイルに保存する。一時ファイルに書いてから置き換える。
+     *          Windowsで読み込んだ一覧ファイルに上書きする場合は、割り当てを解除するため
+     *          一覧の文字列をアリーナに移す(get_entriesとfindで得た値は使えなくなる)。
+     * @param   catalog_path : 一覧ファイルのパス
+     * @return  保存できればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool save(const std::string& catalog_path);
+    /**************************************************************************
+     * @brief   ディレクトリのgspatchファイルと一覧を突き合わせる。
+     *          大きさか更新時刻が変わったファイルと新しいファイルだけを並列に読み、
+     *          なくなったファイルは一覧から除く。
+     * @param   root_path : パッチライブラリのディレクトリ
+     * @param   config : 読み込みの設定の参照
+     * @return  ディレクトリをたどれればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool update(const std::string& root_path, const GsPatchScanConfig& config);
+
+    /**************************************************************************
+     * @brief   一覧を取得する。
+     * @return  ファイルパスの順に並んだ一覧の参照。次にload、updateを呼ぶまで有効。
+     **************************************************************************/
+    const std::vector<GsCatalogEntry>& get_entries() const;
+    /**************************************************************************
+     * @brief   ファイルパスで一覧を引く。
+     * @param   file_path : ファイルパス
+     * @return  見つかれば一覧の要素へのポインタを返す。それ以外の場合にnullptrを返す。
+     *          次にload、updateを呼ぶまで有効。
+     **************************************************************************/
+    const GsCatalogEntry* find(const std::string& file_path) const;
+    /**************************************************************************
+     * @brief   直前のupdateで読んだファイルの数を調べる。
+     * @return  読んだファイルの数
+     **************************************************************************/
+    size_t get_parsed_count() const;
+
+private:
+    bool load_records();
+    bool is_mapped(const GameSynthPatchView& view) const;
+    void store_entry(GameSynthPatchView& view, gspatch_arena& to_arena) const;
+
+private:
+    std::vector<GsCatalogEntry> entries;                                        /* ファイルパスの順の一覧 */
+    gspatch_file                file;                                           /* 割り当てた一覧ファイル */
+    std::string                 file_path;                                      /* 割り当てた一覧ファイルのパス */
+    std::unique_ptr<gspatch_arena> arena;                                       /* 読み直したファイルの値 */
+    size_t                      parsed_count;                                   /* 直前のupdateで読んだファイルの数 */
+};
+
+#endif /* GSPATCH_CATALOG_H */
@@ -0,0 +1,118 @@
+﻿/****************************************************************
+ * @file    gspatch_file.h
+ * @brief   gspatchファイルをメモリに割り当てて読む
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSPATCH_FILE_H
+#define GSPATCH_FILE_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSPATCH_ARENA_BLOCK_SIZE    (64 * 1024)                                 /* アリーナが一度に確保する大きさ [バイト] */
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* gspatchファイルのヘッダー。gspatch_fileかgspatch_arenaの文字列を指す */
+typedef struct GameSynthPatchViewStruct {
+    std::string_view filepath;              /* ファイルパス */
+    std::string_view tool_version;          /* パッチを作成したツールバージョン */
+    std::string_view patch_name;            /* パッチの種類 */
+    std::string_view patch_version;         /* パッチのバージョン */
+    std::string_view author;                /* パッチの製作者 */
+    std::string_view ucs_category;          /* UCS規格のカテゴリ */
+    std::string_view ucs_sub_catebory;      /* UCS規格のサブカテゴリ */
+} GameSynthPatchView;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * ファイルを読み取り専用でメモリに割り当てる。ファイルの内容をヒープに複製しない。
+ */
+class gspatch_file
+{
+public:
+    gspatch_file();
+    ~gspatch_file();
+    gspatch_file(const gspatch_file&) = delete;
+    gspatch_file& operator=(const gspatch_file&) = delete;
+
+    /**************************************************************************
+     * @brief   ファイルをメモリに割り当てる。前に割り当てていたファイルは閉じる。
+     * @param   file_path : ファイルパス(UTF-8)
+     * @return  割り当てられればtrueを返す(空のファイルもtrue)。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool open(const std::string& file_path);
+    /**************************************************************************
+     * @brief   割り当てを解除する。view()で得た文字列は使えなくなる。
+     **************************************************************************/
+    void close();
+    /**************************************************************************
+     * @brief   ファイルの内容を取得する。
+     * @return  ファイルの内容。closeするか破棄するまで有効。
+     **************************************************************************/
+    std::string_view view() const;
+
+private:
+    const char*     data;                                                       /* 割り当てた先頭 */
+    size_t          size;                                                       /* ファイルの大きさ [バイト] */
+#if (_WIN32)
+    void*           file_handle;                                                /* ファイルのハンドル */
+    void*           mapping_handle;                                             /* 割り当てのハンドル */
+#else
+    int             file_descriptor;                                            /* ファイル記述子 */
+#endif
+};
+
+/*
+ * 文字列をまとめて確保した領域に詰めて保持する。
+ * 多数のファイルのヘッダーを集めても、文字列ごとにヒープを確保しない。
+ */
+class gspatch_arena
+{
+public:
+    /**************************************************************************
+     * @brief   領域の確保の単位を指定して作る。
+     * @param   block_size : 一度に確保する大きさ [バイト]。これより長い文字列はそれだけで確保する。
+     **************************************************************************/
+    explicit gspatch_arena(const size_t block_size = GSPATCH_ARENA_BLOCK_SIZE);
+    gspatch_arena(const gspatch_arena&) = delete;
+    gspatch_arena& operator=(const gspatch_arena&) = delete;
+
+    /**************************************************************************
+     * @brief   文字列を複製して保持する。
+     * @param   text : 複製する文字列
+     * @return  複製した文字列。clearするか破棄するまで有効。
+     **************************************************************************/
+    std::string_view store(std::string_view text);
+    /**************************************************************************
+     * @brief   保持している文字列をすべて捨てる。
+     **************************************************************************/
+    void clear();
+    /**************************************************************************
+     * @brief   保持している文字列の合計の大きさを調べる。
+     * @return  合計の大きさ [バイト]
+     **************************************************************************/
+    size_t size() const;
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;                                /* 確保した領域 */
+    size_t          block_size;                                                 /* 一度に確保する大きさ [バイト] */
+    char*           current;                                                    /* 詰めている領域の空きの先頭 */
+    size_t          available;                                                  /* 詰めている領域の空き [バイト] */
+    size_t          stored_size;                                                /* 保持している文字列の合計 [バイト] */
+};
+
+#endif /* GSPATCH_FILE_H */
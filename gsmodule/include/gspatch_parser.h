@@ -1,7 +1,7 @@
 ﻿/****************************************************************
  * @file    gspatch_parser.h
  * @brief   gspatchを解釈する
- * @version 1.0.0
+ * @version 1.0.3
  * @auther  ysd
  ****************************************************************/
 #ifndef GSPATCH_PARSER_H
@@ -10,7 +10,17 @@
 /****************************************************************
  * インクルード
  ****************************************************************/
+#include "gspatch_file.h"
+#include <array>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+
+namespace tinyxml2 {
+class XMLDocument;
+class XMLElement;
+}
 
 /****************************************************************
  * 構造体宣言
@@ -25,6 +35,38 @@ typedef struct GameSynthPatchDataStruct {
     std::string ucs_sub_catebory    = "";   /* UCS規格のサブカテゴリ */
 } GameSynthPatchData;
 
+/* gspatchの要素の属性 */
+typedef struct GsPatchAttributeStruct {
+    std::string name                = "";   /* 属性名 */
+    std::string value               = "";   /* 値 */
+} GsPatchAttribute;
+
+/* gspatchの要素(セクションの各項目)を格納する構造体 */
+typedef struct GsPatchRecordStruct {
+    std::string name                = "";   /* 要素名 */
+    std::vector<GsPatchAttribute> attributes;   /* 属性(ファイルに書かれた順) */
+    std::string text                = "";   /* 要素のテキスト */
+    std::vector<GsPatchRecordStruct> children;  /* 子要素 */
+} GsPatchRecord;
+
+/* gspatchのセクション */
+typedef enum GsPatchSectionIdEnum {
+    GSPATCH_SECTION_ALGO_PARAMETERS = 0,    /* AlgoParameters */
+    GSPATCH_SECTION_PARAMETERS,             /* Parameters */
+    GSPATCH_SECTION_META_PARAMETERS,        /* MetaParameters */
+    GSPATCH_SECTION_EVENTS,                 /* Events */
+    GSPATCH_SECTION_AUTOMATION_CURVES,      /* AutomationCurves */
+    GSPATCH_SECTION_INPUT_CONTROLS,         /* InputControls */
+    GSPATCH_SECTION_RANDOM_PLAY,            /* RandomPlay */
+    GSPATCH_SECTION_COUNT                   /* セクションの数 */
+} GsPatchSectionId;
+
+/* gspatchのセクションを格納する構造体 */
+typedef struct GsPatchSectionStruct {
+    bool        is_found            = false;    /* ファイルにセクションがあったか */
+    GsPatchRecord record;                   /* セクションの要素。子要素がセクションの各項目 */
+} GsPatchSection;
+
 /****************************************************************
  * クラス宣言
  ****************************************************************/
@@ -38,6 +80,105 @@ public:
      * @return  パースに成功するとtrueを返す。それ以外のときにfalseを返す。
      ***************************************************************************/
     static bool parse(const std::string& text_data, GameSynthPatchData& gspatch_data);
+    /***************************************************************************
+     * @brief   gspatchファイルのヘッダーだけを、DOMを作らずに読む。
+     *          ヘッダーがそろった時点で読むのをやめ、セクションの中身は解釈しないので、
+     *          パッチの大きさによらず少ないメモリで一覧を作れる。
+     * @param   text_data : gspatchファイルのテキストデータ
+     * @param   gspatch_data : gspatchファイルのヘッダーを格納する参照
+     * @return  Patch要素を読めればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool parse_header(std::string_view text_data, GameSynthPatchData& gspatch_data);
+    /***************************************************************************
+     * @brief   gspatchファイルのヘッダーだけを、文字列を複製せずに読む。
+     * @param   text_data : gspatchファイルのテキストデータ。結果を使い終わるまで保持すること。
+     * @param   gspatch_view : テキストデータを指すヘッダーを格納する参照(filepathは変更しない)
+     * @param   arena : 実体参照を戻した値を置くアリーナの参照
+     * @return  Patch要素を読めればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool parse_header(std::string_view text_data, GameSynthPatchView& gspatch_view, gspatch_arena& arena);
+    /***************************************************************************
+     * @brief   gspatchファイルをメモリに割り当てて、ヘッダーだけを読む。
+     * @param   file_path : gspatchファイルのパス
+     * @param   gspatch_data : gspatchファイルのヘッダーを格納する参照
+     * @return  読めればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool parse_file(const std::string& file_path, GameSynthPatchData& gspatch_data);
+    /***************************************************************************
+     * @brief   gspatchファイルをメモリに割り当てて、ヘッダーだけを読む。
+     *          値は割り当てたファイルを指すので、fileを閉じるまで有効。
+     * @param   file_path : gspatchファイルのパス
+     * @param   file : ファイルを割り当てる参照
+     * @param   gspatch_view : ヘッダーを格納する参照
+     * @param   arena : ファイルパスと実体参照を戻した値を置くアリーナの参照
+     * @return  読めればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool parse_file(const std::string& file_path, gspatch_file& file,
+        GameSynthPatchView& gspatch_view, gspatch_arena& arena);
+    /***************************************************************************
+     * @brief   gspatchファイルをメモリに割り当てて、ヘッダーだけを読む。
+     *          値はすべてアリーナに置き、ファイルはすぐに閉じる。多数のファイルの一覧を作るとき、
+     *          1つのアリーナを使い回せば値ごとにヒープを確保しない。
+     * @param   file_path : gspatchファイルのパス
+     * @param   gspatch_view : ヘッダーを格納する参照。arenaをclearするまで有効。
+     * @param   arena : 値を置くアリーナの参照
+     * @return  読めればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool parse_file(const std::string& file_path, GameSynthPatchView& gspatch_view, gspatch_arena& arena);
+
+    /***************************************************************************
+     * @brief   セクションの要素名を取得する。
+     * @param   id : セクション
+     * @return  要素名(gspatch_element.hの定義)。範囲外の場合は空文字列。
+     ***************************************************************************/
+    static const char* section_name(const GsPatchSectionId id);
+    /***************************************************************************
+     * @brief   要素の属性の値を取得する。
+     * @param   record : 要素の参照
+     * @param   name : 属性名
+     * @param   value : 属性の値を格納する参照
+     * @return  属性があればtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    static bool get_attribute(const GsPatchRecord& record, const std::string& name, std::string& value);
+};
+
+/*
+ * gspatchファイル全体を保持する。ヘッダー(GameSynthPatchData)は読み込み時に取り出し、
+ * パラメータやオートメーションカーブなどのセクションは、初めて参照したときに取り出す。
+ * 一覧を作るだけならgspatch_parser::parse、パッチを編集するならこちらを使う。
+ */
+class gspatch_model
+{
+public:
+    gspatch_model();
+    ~gspatch_model();
+    gspatch_model(const gspatch_model&) = delete;
+    gspatch_model& operator=(const gspatch_model&) = delete;
+
+    /***************************************************************************
+     * @brief   gspatchファイルをパースして保持する。前に保持していた内容は捨てる。
+     * @param   text_data : gspatchファイルのテキストデータの参照
+     * @return  パースに成功するとtrueを返す。それ以外のときにfalseを返す。
+     ***************************************************************************/
+    bool parse(const std::string& text_data);
+    /***************************************************************************
+     * @brief   ヘッダーを取得する。
+     * @return  gspatchファイルのヘッダーの参照
+     ***************************************************************************/
+    const GameSynthPatchData& get_header() const;
+    /***************************************************************************
+     * @brief   セクションを取得する。初めて参照したときにXMLから取り出す。
+     *          複数のスレッドから参照する場合は、呼び出し側で排他すること。
+     * @param   id : セクション
+     * @return  セクションの参照。ファイルになければis_foundがfalseの空のセクション。
+     ***************************************************************************/
+    const GsPatchSection& get_section(const GsPatchSectionId id);
+
+private:
+    std::unique_ptr<tinyxml2::XMLDocument> document;                /* パースしたXML */
+    GameSynthPatchData  header;                                     /* ヘッダー */
+    std::array<GsPatchSection, GSPATCH_SECTION_COUNT> sections;     /* 取り出したセクション */
+    std::array<bool, GSPATCH_SECTION_COUNT> is_decoded;             /* セクションを取り出したか */
 };
 
 #endif /* GSPATCH_PARSER_H */
\ No newline at end of file
@@ -0,0 +1,107 @@
+﻿/****************************************************************
+ * @file    gspatch_reader.h
+ * @brief   gspatchをDOMを作らずに先頭から順に読む
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSPATCH_READER_H
+#define GSPATCH_READER_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 読み取った字句の種類 */
+typedef enum GsPatchTokenTypeEnum {
+    GSPATCH_TOKEN_START = 0,                /* 要素の開始(<name ...>、<name .../>) */
+    GSPATCH_TOKEN_END,                      /* 要素の終了(</name>、<name .../>の直後) */
+    GSPATCH_TOKEN_TEXT,                     /* 要素のテキスト(空白だけのテキストは読み飛ばす) */
+} GsPatchTokenType;
+
+/* 要素の属性。テキストデータを指す */
+typedef struct GsPatchAttributeViewStruct {
+    std::string_view name;                  /* 属性名 */
+    std::string_view value;                 /* 値(実体参照はそのまま) */
+} GsPatchAttributeView;
+
+/* 読み取った字句。テキストデータを指すので、テキストデータより長く使わないこと */
+typedef struct GsPatchTokenStruct {
+    GsPatchTokenType type = GSPATCH_TOKEN_START;    /* 種類 */
+    std::string_view name;                  /* 要素名(START, END) */
+    std::string_view text;                  /* テキスト(TEXT。実体参照はそのまま) */
+    std::vector<GsPatchAttributeView> attributes;   /* 属性(START。容量は次の字句でも使い回す) */
+    size_t      depth = 0;                  /* 要素の深さ。ルート要素が1 */
+} GsPatchToken;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * gspatchを先頭から1字句ずつ読む(プルパーサ)。DOMを作らず、文字列も複製しないので、
+ * 使うメモリは要素の深さと1要素の属性の数だけで決まり、ファイルの大きさによらない。
+ * 必要な要素を読んだ時点で読むのをやめられる。
+ * 宣言(<?...?>)、コメント、DOCTYPEは読み飛ばし、CDATAはテキストとして返す。
+ */
+class gspatch_reader
+{
+public:
+    /**************************************************************************
+     * @brief   読み始める。
+     * @param   text_data : gspatchファイルのテキストデータ。読み終わるまで保持すること。
+     **************************************************************************/
+    explicit gspatch_reader(std::string_view text_data);
+
+    /**************************************************************************
+     * @brief   次の字句を読む。
+     * @param   token : 読み取った字句を格納する参照
+     * @return  読み取れればtrueを返す。終わりに達した、形式が正しくない場合にfalseを返す。
+     **************************************************************************/
+    bool next(GsPatchToken& token);
+    /**************************************************************************
+     * @brief   直前に開始した要素の終わりまで読み飛ばす。属性は解釈しない。
+     *          STARTの直後に呼ぶと、対応するENDは返さない。
+     * @return  読み飛ばせればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool skip_element();
+    /**************************************************************************
+     * @brief   形式が正しくなかったか。
+     * @return  形式の誤りで止まった場合にtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    bool is_error() const;
+
+    /**************************************************************************
+     * @brief   属性の値を探す。
+     * @param   token : 字句の参照
+     * @param   name : 属性名
+     * @param   value : 値を格納する参照
+     * @return  属性があればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool find_attribute(const GsPatchToken& token, std::string_view name, std::string_view& value);
+    /**************************************************************************
+     * @brief   実体参照(&lt; &gt; &amp; &quot; &apos; &#...;)を文字に戻す。
+     * @param   text : 属性の値やテキスト
+     * @param   value : 戻した文字列を格納する参照
+     **************************************************************************/
+    static void unescape(std::string_view text, std::string& value);
+
+private:
+    bool read_tag(GsPatchToken& token);
+    bool read_attributes(GsPatchToken& token, bool& is_empty);
+    bool fail();
+
+private:
+    std::string_view                text_data;                                  /* テキストデータ */
+    size_t                          position;                                   /* 次に読む位置 */
+    std::vector<std::string_view>   open_elements;                              /* 開始した要素名(終了との対応を確かめる) */
+    bool                            is_pending_end;                             /* 空要素のENDをまだ返していないか */
+    bool                            has_error;                                  /* 形式の誤りで止まったか */
+};
+
+#endif /* GSPATCH_READER_H */
@@ -0,0 +1,93 @@
+﻿/****************************************************************
+ * @file    gspatch_scanner.h
+ * @brief   パッチライブラリのgspatchファイルを並列に読む
+ * @version 1.0.2
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSPATCH_SCANNER_H
+#define GSPATCH_SCANNER_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "gspatch_parser.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* パッチライブラリの読み込みの設定 */
+typedef struct GsPatchScanConfigStruct {
+    unsigned int    thread_count    = 0;                                        /* 読み込むスレッドの数(0でCPUのコア数) */
+    bool            is_recursive    = true;                                     /* 下位のディレクトリも読むか */
+} GsPatchScanConfig;
+
+/* 見つけたgspatchファイル */
+typedef struct GsPatchFileStruct {
+    std::string     filepath;                                                   /* ファイルパス */
+    uint64_t        file_size       = 0;                                        /* 大きさ [バイト] */
+    int64_t         modified_time   = 0;                                        /* 更新時刻(UNIX時刻からのナノ秒) */
+} GsPatchFile;
+
+/* 読み込んだgspatchファイルの受け取り(読み込むスレッドで並行して呼ばれる) */
+typedef std::function<void(bool result, const GameSynthPatchData& gspatch_data)> GsPatchHandler;
+
+/****************************************************************
+ * クラス宣言
+ ****************************************************************/
+/*
+ * ディレクトリをたどりながら、見つけたgspatchファイルのヘッダーを複数のスレッドで読む。
+ * 見つけたファイルはスレッドごとの待ち行列に順に振り分け、自分の待ち行列が空いた
+ * スレッドは他のスレッドの待ち行列から取る(ワークスティーリング)。
+ */
+class gspatch_scanner
+{
+public:
+    /**************************************************************************
+     * @brief   ディレクトリ内のgspatchファイルを読み、1ファイルごとにhandlerを呼ぶ。
+     *          handlerは読み込むスレッドから並行して呼ばれるので、排他は呼び出し側で行うこと。
+     *          読めなかったファイルは、resultをfalse、filepathだけを設定して呼ぶ。
+     * @param   root_path : パッチライブラリのディレクトリ
+     * @param   config : 読み込みの設定の参照
+     * @param   handler : 読み込んだファイルの受け取り
+     * @return  ディレクトリをたどれればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool scan(const std::string& root_path, const GsPatchScanConfig& config, const GsPatchHandler& handler);
+    /**************************************************************************
+     * @brief   ディレクトリ内のgspatchファイルを読み、一覧にする。
+     * @param   root_path : パッチライブラリのディレクトリ
+     * @param   config : 読み込みの設定の参照
+     * @param   catalog : 読めたファイルをファイルパスの順に格納する配列の参照
+     * @return  ディレクトリをたどれればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool scan(const std::string& root_path, const GsPatchScanConfig& config, std::vector<GameSynthPatchData>& catalog);
+    /**************************************************************************
+     * @brief   指定したgspatchファイルを読み、1ファイルごとにhandlerを呼ぶ。
+     *          handlerの呼ばれ方はscanと同じ。configのis_recursiveは使わない。
+     * @param   file_paths : 読むファイルのパスの配列の参照
+     * @param   config : 読み込みの設定の参照
+     * @param   handler : 読み込んだファイルの受け取り
+     * @return  常にtrueを返す。
+     **************************************************************************/
+    static bool scan_files(const std::vector<std::string>& file_paths, const GsPatchScanConfig& config,
+        const GsPatchHandler& handler);
+    /**************************************************************************
+     * @brief   ディレクトリ内のgspatchファイルを探し、大きさと更新時刻を調べる。ファイルは読まない。
+     * @param   root_path : パッチライブラリのディレクトリ
+     * @param   is_recursive : 下位のディレクトリも探すか
+     * @param   files : 見つけたファイルを格納する配列の参照
+     * @return  ディレクトリをたどれればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool find_files(const std::string& root_path, const bool is_recursive, std::vector<GsPatchFile>& files);
+    /**************************************************************************
+     * @brief   gspatchファイルか(拡張子がGSPATCH_PREFIXか)を調べる。大文字と小文字は区別しない。
+     * @param   file_path : ファイルパス
+     * @return  gspatchファイルであればtrueを返す。それ以外の場合にfalseを返す。
+     **************************************************************************/
+    static bool is_patch_file(const std::string& file_path);
+};
+
+#endif /* GSPATCH_SCANNER_H */
@@ -0,0 +1,897 @@
+﻿/****************************************************************
+ * @file    gsapi_async_client.cpp
+ * @brief   GameSynth Tool APIを非同期に呼び出す
+ * @version 1.0.3
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_async_client.h"
+#include "../include/gsapi_codec.h"
+#include "../include/gsapi_curve.h"
+#include "gsapi_socket.h"
+#if defined(__linux__)
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+#endif
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+/* ツールから受信するメッセージサイズ */
+#define RECEIVE_BUFFER_INITIAL_SIZE     (4096)
+#define MAX_RECEIVE_MESSAGE_SIZE        (64 * 1024 * 1024)
+
+/* I/Oスレッドの待機方法 */
+#if defined(__linux__)
+    #define GS_ASYNC_USE_EPOLL          (1)
+#else
+    #define GS_ASYNC_USE_EPOLL          (0)
+#endif
+#define ASYNC_POLL_INTERVAL_MSEC        (10)                                    /* epollが使えない環境で新しいコマンドを確認する間隔 [ミリ秒] */
+#define ASYNC_MAX_EVENTS                (4)                                     /* 一度に受け取るepollのイベント数 */
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+template <GsCommandId Id>
+static bool decode_reply(const std::string_view& response, GsAsyncResult<GsReplyValue<Id>>& result);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+template <GsCommandId Id>
+static bool decode_reply(const std::string_view& response, GsAsyncResult<GsReplyValue<Id>>& result)
+{
+    if constexpr (std::is_void_v<GsReplyValue<Id>>) {
+        /* 応答が届けば完了とする */
+        (void)response;
+        (void)result;
+        return true;
+    } else {
+        return gsapi_codec::decode_reply<Id>(response, result.value);
+    }
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_async_client::gsapi_async_client()
+    : config()
+    , io_thread()
+    , running(false)
+    , epoll_fd(-1)
+    , event_fd(-1)
+    , sock(GS_INVALID_SOCKET)
+    , is_waiting_writable(false)
+    , send_offset(0)
+    , receive_buffer(RECEIVE_BUFFER_INITIAL_SIZE)
+    , receive_begin(0)
+    , receive_end(0)
+{
+}
+
+gsapi_async_client::~gsapi_async_client()
+{
+    stop();
+}
+
+bool gsapi_async_client::start(const GsApiClientConfig& config)
+{
+    if (running || io_thread.joinable()) {
+        return false;
+    }
+    if (config.delimiter.empty() || !gsapi_connection::startup()) {
+        return false;
+    }
+    this->config = config;
+#if GS_ASYNC_USE_EPOLL
+    const int new_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    const int new_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = new_event_fd;
+    if (new_epoll_fd < 0 || new_event_fd < 0 || epoll_ctl(new_epoll_fd, EPOLL_CTL_ADD, new_event_fd, &event) != 0) {
+        perror("[gsmodule]failed to create epoll.\n");
+        if (new_epoll_fd >= 0) {
+            close(new_epoll_fd);
+        }
+        if (new_event_fd >= 0) {
+            close(new_event_fd);
+        }
+        return false;
+    }
+#endif
+    {
+        /* wakeはディスクリプタを排他中に読むので、差し替えも排他中に行う */
+        std::lock_guard<std::mutex> lock(mutex);
+#if GS_ASYNC_USE_EPOLL
+        epoll_fd = new_epoll_fd;
+        event_fd = new_event_fd;
+#endif
+        running = true;
+    }
+    io_thread = std::thread(&gsapi_async_client::run, this);
+    return true;
+}
+
+void gsapi_async_client::stop()
+{
+    {
+        /* send_commandの受付とI/Oスレッドの終了処理が行き違わないよう、排他中に止める */
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        wake();
+    }
+    if (io_thread.get_id() == std::this_thread::get_id()) {
+        /* completionから呼ばれた。自分自身は待てないので、戻った後にI/Oスレッドが終わる */
+        return;
+    }
+    if (io_thread.joinable()) {
+        io_thread.join();
+    }
+#if GS_ASYNC_USE_EPOLL
+    /* 受付を締め切った後でも、send_commandが排他中にwakeを呼んでいるかもしれない */
+    std::lock_guard<std::mutex> lock(mutex);
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (event_fd >= 0) {
+        close(event_fd);
+        event_fd = -1;
+    }
+#endif
+}
+
+bool gsapi_async_client::is_running() const
+{
+    return running;
+}
+
+bool gsapi_async_client::send_command(const std::string& message, const GsResponseHandler& handler)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running) {
+        return false;
+    }
+    /* 取り込み待ちのコマンドがあれば、I/Oスレッドは既に起こしてある */
+    if (requests.empty()) {
+        wake();
+    }
+    requests.push_back({ message, handler });
+    return true;
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::send_command(const std::string& message)
+{
+    /* 応答はそのまま文字列で受け取る */
+    auto promise = std::make_shared<std::promise<GsAsyncResult<std::string>>>();
+    std::future<GsAsyncResult<std::string>> future = promise->get_future();
+    const GsResponseHandler handler = [promise](bool result, std::string_view response) {
+        GsAsyncResult<std::string> async_result;
+        async_result.result = result;
+        async_result.value = response;
+        promise->set_value(std::move(async_result));
+    };
+    if (!send_command(message, handler)) {
+        handler(false, std::string_view());
+    }
+    return future;
+}
+
+template <GsCommandId Id>
+std::future<GsAsyncResult<GsReplyValue<Id>>> gsapi_async_client::request(const bool is_encoded, const std::string& message,
+    const GsCompletion<GsReplyValue<Id>>& completion)
+{
+    /* 値の型と応答の解析はGSAPI_COMMAND_TABLEの応答の種類で決まる */
+    typedef GsReplyValue<Id> T;
+    auto promise = std::make_shared<std::promise<GsAsyncResult<T>>>();
+    std::future<GsAsyncResult<T>> future = promise->get_future();
+    const GsResponseHandler handler = [promise, completion](bool result, std::string_view response) {
+        GsAsyncResult<T> async_result;
+        async_result.result = result && decode_reply<Id>(response, async_result);
+        if (completion) {
+            completion(async_result);
+        }
+        promise->set_value(std::move(async_result));
+    };
+    if (!is_encoded || !send_command(message, handler)) {
+        handler(false, std::string_view());
+    }
+    return future;
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::request_batch(const std::vector<std::string>& messages, const GsCompletion<>& completion)
+{
+    /* すべての応答が揃った時点で完了する */
+    struct batch_state {
+        std::promise<GsAsyncResult<>>   promise;
+        GsCompletion<>                  completion;
+        std::atomic<size_t>             remaining;
+        std::atomic<bool>               result;
+    };
+    auto state = std::make_shared<batch_state>();
+    state->completion = completion;
+    state->remaining = messages.size() + 1;
+    state->result = true;
+    std::future<GsAsyncResult<>> future = state->promise.get_future();
+    const GsResponseHandler handler = [state](bool result, std::string_view response) {
+        (void)response;
+        if (!result) {
+            state->result = false;
+        }
+        if (--state->remaining == 0) {
+            GsAsyncResult<> async_result;
+            async_result.result = state->result;
+            if (state->completion) {
+                state->completion(async_result);
+            }
+            state->promise.set_value(async_result);
+        }
+    };
+
+    /* I/Oスレッドが1回の書き込みで送れるよう、まとめて受け付ける */
+    bool is_accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            if (requests.empty() && !messages.empty()) {
+                wake();
+            }
+            for (const auto& message : messages) {
+                requests.push_back({ message, handler });
+            }
+            is_accepted = true;
+        }
+    }
+    if (!is_accepted) {
+        state->result = false;
+        state->remaining -= messages.size();
+    }
+    /* 受付分の数え終わり */
+    handler(is_accepted, std::string_view());
+    return future;
+}
+
+void gsapi_async_client::run()
+{
+    while (running) {
+        /* 最も古い応答待ちコマンドの期限まで待つ */
+        int timeout_msec = -1;
+        if (!pendings.empty()) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                pendings.front().deadline - std::chrono::steady_clock::now()).count();
+            timeout_msec = static_cast<int>(std::max<long long>(remaining, 0) + 1);
+        }
+        bool is_readable = false;
+        bool is_writable = false;
+        bool is_ok = wait_events(timeout_msec, is_readable, is_writable);
+        is_ok = is_ok && accept_requests();
+        if (is_ok && is_readable) {
+            is_ok = receive_responses();
+        }
+        if (is_ok && (send_offset < send_buffer.size())) {
+            is_ok = flush_send();
+        }
+        if (is_ok && !pendings.empty() && (pendings.front().deadline <= std::chrono::steady_clock::now())) {
+            /* 応答の順番が分からなくなるので、残りのコマンドもまとめて失敗にする */
+            perror("[gsmodule]failed to receive message due to timeout.");
+            is_ok = false;
+        }
+        if (!is_ok) {
+            fail_all();
+            continue;
+        }
+        update_interest();
+    }
+
+    /* 停止後に残ったコマンドはすべて失敗として完了する */
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        accepting.swap(requests);
+    }
+    fail_all();
+}
+
+bool gsapi_async_client::wait_events(const int timeout_msec, bool& is_readable, bool& is_writable)
+{
+#if GS_ASYNC_USE_EPOLL
+    epoll_event events[ASYNC_MAX_EVENTS];
+    const int count = epoll_wait(epoll_fd, events, ASYNC_MAX_EVENTS, timeout_msec);
+    if (count < 0) {
+        if (is_interrupted()) {
+            return true;
+        }
+        perror("[gsmodule]failed to wait events.");
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (events[i].data.fd == event_fd) {
+            std::uint64_t value = 0;
+            while (read(event_fd, &value, sizeof(value)) > 0) {
+            }
+            continue;
+        }
+        if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+            is_readable = true;
+        }
+        if (events[i].events & EPOLLOUT) {
+            is_writable = true;
+        }
+    }
+    return true;
+#else
+    if (sock == GS_INVALID_SOCKET) {
+        /* 接続前はコマンドの受付だけを待つ */
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto predicate = [this]() { return !requests.empty() || !running; };
+        if (timeout_msec < 0) {
+            condition.wait(lock, predicate);
+        } else {
+            condition.wait_for(lock, std::chrono::milliseconds(timeout_msec), predicate);
+        }
+        return true;
+    }
+    /* 新しいコマンドを取り込めるよう、一定間隔で起きる */
+    const int interval_msec = (timeout_msec < 0) ? ASYNC_POLL_INTERVAL_MSEC : std::min(timeout_msec, ASYNC_POLL_INTERVAL_MSEC);
+    pollfd pfd = {};
+    pfd.fd = sock;
+    pfd.events = POLLIN | (is_waiting_writable ? POLLOUT : 0);
+    const int result = GS_POLL(&pfd, 1, interval_msec);
+    if (result < 0) {
+        if (is_interrupted()) {
+            return true;
+        }
+        perror("[gsmodule]failed to wait events.");
+        return false;
+    }
+    is_readable = (pfd.revents & (POLLIN | POLLERR | POLLHUP)) != 0;
+    is_writable = (pfd.revents & POLLOUT) != 0;
+    return true;
+#endif
+}
+
+void gsapi_async_client::wake()
+{
+    /* stopがevent_fdを閉じるのと行き違わないよう、mutexを保持して呼ぶ */
+#if GS_ASYNC_USE_EPOLL
+    const std::uint64_t value = 1;
+    if (event_fd >= 0) {
+        (void)!write(event_fd, &value, sizeof(value));
+    }
+#else
+    condition.notify_one();
+#endif
+}
+
+bool gsapi_async_client::accept_requests()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (requests.empty()) {
+            return true;
+        }
+        accepting.swap(requests);
+    }
+
+    if (sock == GS_INVALID_SOCKET) {
+        sock = open_socket(config.ip_address, config.port_number, config.connect_timeout_msec);
+        if (sock == GS_INVALID_SOCKET) {
+            /* 接続できなければ、取り込んだコマンドだけを失敗にする */
+            fail_all();
+            return true;
+        }
+#if GS_ASYNC_USE_EPOLL
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = sock;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &event);
+#endif
+    }
+
+    /* 送信データは連結し、応答はメッセージを送った順に受け取る */
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.receive_timeout_msec);
+    for (auto& accepted : accepting) {
+        send_buffer += accepted.message;
+        pendings.push_back({ std::move(accepted.handler), deadline });
+    }
+    accepting.clear();
+    return true;
+}
+
+bool gsapi_async_client::flush_send()
+{
+    while (send_offset < send_buffer.size()) {
+        const int sent = static_cast<int>(send(sock, send_buffer.data() + send_offset,
+            static_cast<int>(send_buffer.size() - send_offset), GS_SEND_FLAGS));
+        if (sent < 0) {
+            if (is_interrupted()) {
+                continue;
+            }
+            if (is_would_block()) {
+                /* 送信可能になってから続きを送る */
+                return true;
+            }
+            perror("[gsmodule]failed to send message.\n");
+            return false;
+        }
+        send_offset += static_cast<size_t>(sent);
+    }
+    send_buffer.clear();
+    send_offset = 0;
+    return true;
+}
+
+bool gsapi_async_client::receive_responses()
+{
+    const std::string& delimiter = config.delimiter;
+    while (1) {
+        /* バッファが埋まっていれば、読み終えた分を詰めるか拡張する */
+        if (receive_end == receive_buffer.size()) {
+            if (receive_begin > 0) {
+                std::memmove(receive_buffer.data(), receive_buffer.data() + receive_begin, receive_end - receive_begin);
+                receive_end -= receive_begin;
+                receive_begin = 0;
+            } else if (receive_buffer.size() >= MAX_RECEIVE_MESSAGE_SIZE) {
+                perror("[gsmodule]received message is too large.");
+                return false;
+            } else {
+                receive_buffer.resize(receive_buffer.size() * 2);
+            }
+        }
+
+        const int len = static_cast<int>(recv(sock, receive_buffer.data() + receive_end,
+            static_cast<int>(receive_buffer.size() - receive_end), 0));
+        if (len == 0) {
+            perror("[gsmodule]connection closed by peer.");
+            return false;
+        }
+        if (len < 0) {
+            if (is_interrupted()) {
+                continue;
+            }
+            if (is_would_block()) {
+                return true;
+            }
+            perror("[gsmodule]failed to receive message.");
+            return false;
+        }
+        receive_end += static_cast<size_t>(len);
+
+        /* 揃った応答を送信した順に渡す */
+        while (1) {
+            const std::string_view received(receive_buffer.data() + receive_begin, receive_end - receive_begin);
+            const size_t found = received.find(delimiter);
+            if (found == std::string_view::npos) {
+                break;
+            }
+            receive_begin += found + delimiter.size();
+            if (pendings.empty()) {
+                /* 要求していない応答は読み捨てる */
+                continue;
+            }
+            const GsResponseHandler handler = std::move(pendings.front().handler);
+            pendings.pop_front();
+            handler(true, received.substr(0, found));
+        }
+        if (receive_begin == receive_end) {
+            receive_begin = 0;
+            receive_end = 0;
+        }
+    }
+}
+
+void gsapi_async_client::update_interest()
+{
+    /* 未送信のデータがある間だけ送信可能を待つ */
+    const bool is_pending_send = (send_offset < send_buffer.size());
+    if (sock == GS_INVALID_SOCKET || is_pending_send == is_waiting_writable) {
+        return;
+    }
+    is_waiting_writable = is_pending_send;
+#if GS_ASYNC_USE_EPOLL
+    epoll_event event = {};
+    event.events = is_waiting_writable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.fd = sock;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, sock, &event);
+#endif
+}
+
+void gsapi_async_client::fail_all()
+{
+    close_socket();
+    std::deque<GsAsyncPending> failed_pendings;
+    failed_pendings.swap(pendings);
+    std::deque<GsAsyncRequest> failed_requests;
+    failed_requests.swap(accepting);
+    for (auto& pending : failed_pendings) {
+        pending.handler(false, std::string_view());
+    }
+    for (auto& request : failed_requests) {
+        request.handler(false, std::string_view());
+    }
+}
+
+void gsapi_async_client::close_socket()
+{
+    if (sock != GS_INVALID_SOCKET) {
+#if GS_ASYNC_USE_EPOLL
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock, nullptr);
+#endif
+        GS_CLOSE_SOCKET(sock);
+        sock = GS_INVALID_SOCKET;
+    }
+    is_waiting_writable = false;
+    send_buffer.clear();
+    send_offset = 0;
+    receive_begin = 0;
+    receive_end = 0;
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_version(const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_version(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_VERSION>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_get_commands(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_commands(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_COMMANDS>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_get_models(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_models(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_MODELS>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_select_model(const std::string& model_name, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_select_model(model_name, config.delimiter, send_message);
+    return request<GS_COMMAND_SELECT_MODEL>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_path(const std::string& path_name, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_path(path_name, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_PATH>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_samplerate(const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_samplerate(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_SAMPLERATE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_samplerate(const std::string& samplerate, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_set_samplerate(samplerate, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_SAMPLERATE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_query_patchnames(const std::string& text, const bool name,
+    const bool category, const bool tags, const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_query_patchnames(text, name, category, tags, config.delimiter, send_message);
+    return request<GS_COMMAND_QUERY_PATCHNAMES>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_query_patch(const std::string& patch_name, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_query_patch(patch_name, config.delimiter, send_message);
+    return request<GS_COMMAND_QUERY_PATCH>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_query_categories(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_query_categories(config.delimiter, send_message);
+    return request<GS_COMMAND_QUERY_CATEGORIES>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_query_tags(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_query_tags(config.delimiter, send_message);
+    return request<GS_COMMAND_QUERY_TAGS>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_load_patch(const std::string& file_path, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_load_patch(file_path, config.delimiter, send_message);
+    return request<GS_COMMAND_LOAD_PATCH>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_save_patch(const std::string& file_path, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_save_patch(file_path, config.delimiter, send_message);
+    return request<GS_COMMAND_SAVE_PATCH>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_render_patch(const std::string& file_path, const unsigned int depth,
+    const unsigned int channel, const unsigned int duration, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_render_patch(file_path, depth, channel, duration, config.delimiter, send_message);
+    return request<GS_COMMAND_RENDER_PATCH>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_modelname(const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_modelname(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_MODELNAME>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_patchname(const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_patchname(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_PATCHNAME>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<float>> gsapi_async_client::command_get_variation(const GsCompletion<float>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_variation(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_VARIATION>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_variation(const float& variation, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_set_variation(variation, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_VARIATION>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<GsDrawingData>>> gsapi_async_client::command_get_drawing(const unsigned int index, const GsCompletion<std::vector<GsDrawingData>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_drawing(index, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_DRAWING>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_drawing(const std::vector<GsDrawingData>& drawing_data, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_set_drawing(drawing_data, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_DRAWING>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<unsigned int>> gsapi_async_client::command_get_metacount(const GsCompletion<unsigned int>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_metacount(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_METACOUNT>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_get_metanames(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_metanames(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_METANAMES>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_metaname(const unsigned int& index, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_metaname(index, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_METANAME>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<float>> gsapi_async_client::command_get_metavalue(const unsigned int& index, const GsCompletion<float>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_metavalue(index, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_METAVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<float>> gsapi_async_client::command_get_metavalue(const std::string& name, const GsCompletion<float>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_metavalue(name, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_METAVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_metavalue(const unsigned int& index, const float& metavalue, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_set_metavalue(index, metavalue, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_METAVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_metavalue(const std::string& name, const float& metavalue, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_set_metavalue(name, metavalue, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_METAVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues,
+    const GsCompletion<>& completion)
+{
+    std::vector<std::string> messages(metavalues.size());
+    for (size_t i = 0; i < metavalues.size(); i++) {
+        const GsMetaValueEntry& entry = metavalues[i];
+        if (std::holds_alternative<unsigned int>(entry.target)) {
+            gsapi_codec::encode_set_metavalue(std::get<unsigned int>(entry.target), entry.value, config.delimiter, messages[i]);
+        } else {
+            gsapi_codec::encode_set_metavalue(std::get<std::string>(entry.target), entry.value, config.delimiter, messages[i]);
+        }
+    }
+    return request_batch(messages, completion);
+}
+
+std::future<GsAsyncResult<unsigned int>> gsapi_async_client::command_get_curvescount(const GsCompletion<unsigned int>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_curvescount(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_CURVESCOUNT>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::vector<std::string>>> gsapi_async_client::command_get_curvenames(const GsCompletion<std::vector<std::string>>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_curvenames(config.delimiter, send_message);
+    return request<GS_COMMAND_GET_CURVENAMES>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_get_curvename(const unsigned int& curve_index, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_curvename(curve_index, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_CURVENAME>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<GsCurveValue>> gsapi_async_client::command_get_curvevalue(const unsigned int& curve_index, const GsCompletion<GsCurveValue>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_curvevalue(curve_index, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_CURVEVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<GsCurveValue>> gsapi_async_client::command_get_curvevalue(const std::string& curve_name, const GsCompletion<GsCurveValue>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_get_curvevalue(curve_name, config.delimiter, send_message);
+    return request<GS_COMMAND_GET_CURVEVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    GsCurveValue work;
+    const GsCurveValue& send_value = gsapi_curve::prepare(curve_value, config, work);
+    const bool is_encoded = gsapi_codec::encode_set_curvevalue(curve_index, send_value, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_CURVEVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    GsCurveValue work;
+    const GsCurveValue& send_value = gsapi_curve::prepare(curve_value, config, work);
+    const bool is_encoded = gsapi_codec::encode_set_curvevalue(curve_name, send_value, config.delimiter, send_message);
+    return request<GS_COMMAND_SET_CURVEVALUE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values,
+    const GsCompletion<>& completion)
+{
+    std::vector<std::string> messages(curve_values.size());
+    GsCurveValue work;
+    for (size_t i = 0; i < curve_values.size(); i++) {
+        const GsCurveValueEntry& entry = curve_values[i];
+        const GsCurveValue& send_value = gsapi_curve::prepare(entry.value, config, work);
+        if (std::holds_alternative<unsigned int>(entry.target)) {
+            gsapi_codec::encode_set_curvevalue(std::get<unsigned int>(entry.target), send_value, config.delimiter, messages[i]);
+        } else {
+            gsapi_codec::encode_set_curvevalue(std::get<std::string>(entry.target), send_value, config.delimiter, messages[i]);
+        }
+    }
+    return request_batch(messages, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_play(const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_play(config.delimiter, send_message);
+    return request<GS_COMMAND_PLAY>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_stop(const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_stop(config.delimiter, send_message);
+    return request<GS_COMMAND_STOP>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<bool>> gsapi_async_client::command_is_playing(const GsCompletion<bool>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_is_playing(config.delimiter, send_message);
+    return request<GS_COMMAND_IS_PLAYING>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<bool>> gsapi_async_client::command_is_infinite(const GsCompletion<bool>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_is_infinite(config.delimiter, send_message);
+    return request<GS_COMMAND_IS_INFINITE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<bool>> gsapi_async_client::command_is_randomized(const GsCompletion<bool>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_is_randomized(config.delimiter, send_message);
+    return request<GS_COMMAND_IS_RANDOMIZED>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_enable_events(const bool is_notification, const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_enable_events(is_notification, config.delimiter, send_message);
+    return request<GS_COMMAND_ENABLE_EVENTS>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_window_back(const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_back(config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_BACK>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_window_front(const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_front(config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_FRONT>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_window_message(const std::string& message, const GsWindowButton& button, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_message(message, button, config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_MESSAGE>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_window_parameters(const std::vector<GsParameter>& params, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_parameters(params, config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_PARAMETERS>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<std::string>> gsapi_async_client::command_window_rendering(const bool& show_duration, const bool& show_variations, const GsCompletion<std::string>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_rendering(show_duration, show_variations, config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_RENDERING>(is_encoded, send_message, completion);
+}
+
+std::future<GsAsyncResult<>> gsapi_async_client::command_window_test(const GsCompletion<>& completion)
+{
+    std::string send_message;
+    const bool is_encoded = gsapi_codec::encode_window_test(config.delimiter, send_message);
+    return request<GS_COMMAND_WINDOW_TEST>(is_encoded, send_message, completion);
+}
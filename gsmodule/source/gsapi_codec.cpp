@@ -0,0 +1,894 @@
+﻿/****************************************************************
+ * @file    gsapi_codec.cpp
+ * @brief   GameSynth Tool APIのメッセージを作成し、応答を解析する
+ * @version 1.0.6
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_codec.h"
+#include "../include/gsapi_commands.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+/* ツールから受信するメッセージに含まれるデリミタ */
+#define MESSAGE_DELIMITER_SPACE         ' '
+#define MESSAGE_DELIMITER_COMMA         ','
+
+/* メタパラメータやオートメーションカーブを指定するときに使用する文字列 */
+#define GS_TARGET_BY_INDEX          "BY_INDEX"
+#define GS_TARGET_BY_NAME           "BY_NAME"
+
+/* 数値を文字列にするときの一時領域のサイズ */
+#define NUMBER_BUFFER_SIZE          (32)
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 括弧で囲んだ数値の組を解析するときの状態 */
+typedef enum TupleStateEnum {
+    TUPLE_STATE_BEGIN = 0,                                                      /* 組の前の区切り、引用符、開き括弧を読み飛ばす */
+    TUPLE_STATE_FIELD,                                                          /* 数値を読む */
+    TUPLE_STATE_SEPARATOR,                                                      /* 数値の後のカンマか閉じ括弧を読む */
+    TUPLE_STATE_SKIP                                                            /* 形式が合わない組を閉じ括弧まで読み飛ばす */
+} TupleState;
+
+/* 列挙値ごとにツールに送る文字列。列挙値の順に並べる */
+template<typename T>
+struct GsEnumTokens;
+
+template<>
+struct GsEnumTokens<GsWindowButton> {
+    static constexpr const char* tokens[] = { "OK", "OK_CANCEL", "YES_NO", "RETRY_EXIT" };
+};
+
+template<>
+struct GsEnumTokens<GsDataType> {
+    static constexpr const char* tokens[] = { "NUMBER", "BOOL", "STRING", "ENUM", "LABEL" };
+};
+
+template<>
+struct GsEnumTokens<GsNumberSubType> {
+    static constexpr const char* tokens[] = { "INTEGER", "FLOAT" };
+};
+
+template<>
+struct GsEnumTokens<GsStringSubType> {
+    static constexpr const char* tokens[] = { "NORMAL", "FILELOAD", "FILESAVE", "FOLDER" };
+};
+
+template<>
+struct GsEnumTokens<GsEnumSubType> {
+    static constexpr const char* tokens[] = { "LIST", "COMBO" };
+};
+
+template<>
+struct GsEnumTokens<GsLabelSubType> {
+    static constexpr const char* tokens[] = { "TEXT", "HEADER" };
+};
+
+template<>
+struct GsEnumTokens<GsLabelAlignment> {
+    static constexpr const char* tokens[] = { "LEFT", "RIGHT", "CENTER" };
+};
+
+static_assert(std::size(GsEnumTokens<GsWindowButton>::tokens) == GS_WINDOW_BUTTON_RETRY_EXIT + 1, "GsWindowButton tokens");
+static_assert(std::size(GsEnumTokens<GsDataType>::tokens) == GS_DATA_TYPE_LABEL + 1, "GsDataType tokens");
+static_assert(std::size(GsEnumTokens<GsNumberSubType>::tokens) == GS_NUMBER_SUB_TYPE_FLOAT + 1, "GsNumberSubType tokens");
+static_assert(std::size(GsEnumTokens<GsStringSubType>::tokens) == GS_STRING_SUB_TYPE_FOLDER + 1, "GsStringSubType tokens");
+static_assert(std::size(GsEnumTokens<GsEnumSubType>::tokens) == GS_ENUM_SUB_TYPE_COMBO + 1, "GsEnumSubType tokens");
+static_assert(std::size(GsEnumTokens<GsLabelSubType>::tokens) == GS_LABEL_SUB_TYPE_HEADER + 1, "GsLabelSubType tokens");
+static_assert(std::size(GsEnumTokens<GsLabelAlignment>::tokens) == GS_LABEL_SUB_ALIGNMENT_CENTER + 1, "GsLabelAlignment tokens");
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+template<GsCommandId Id, typename... Args>
+static bool encode_command(const std::string& delimiter, std::string& message, const Args&... args);
+template<typename T>
+static bool append_value(std::string& message, const T& value);
+static void append_argument(std::string& message, const std::string_view& text);
+static void append_quoted(std::string& message, const std::string_view& text);
+static void append_number(std::string& message, const unsigned int value);
+static void append_number(std::string& message, const float value);
+static void append_flag(std::string& message, const bool value);
+static void append_curve(std::string& message, const std::vector<GsCurvePoint>& curve);
+static void append_drawing_point(std::string& message, const float t, const float x, const float y, const float p);
+static bool append_parameter(std::string& message, const GsParameter& param);
+static size_t split_fields(const std::string_view& text, const char delimiter, std::string_view* fields, const size_t max_fields);
+static const char* skip_space(const char* first, const char* last);
+static const char* parse_float(const char* first, const char* last, float& value);
+template<size_t FIELD_COUNT, typename Store>
+static void parse_tuples(const std::string_view& text, Store store);
+static bool string_to_float(const std::string_view& text, float& value);
+static bool string_to_int(const std::string_view& text, int& value);
+template<typename T>
+static bool enum_to_string(const T type, const char*& text);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+template<GsCommandId Id, typename... Args>
+static bool encode_command(const std::string& delimiter, std::string& message, const Args&... args)
+{
+    static_assert(gsapi_is_command_args<Id, Args...>(), "arguments must match GsCommandSpec of the command");
+    /* コマンド名に続けて、引数を空白で区切って並べる */
+    message.assign(gsapi_command(Id).name);
+    if (!(append_value(message, args) && ...)) {
+        return false;
+    }
+    message.append(delimiter);
+    return true;
+}
+
+template<typename T>
+static bool append_value(std::string& message, const T& value)
+{
+    /* 引数の型ごとの書式はここだけで定める */
+    if constexpr (std::is_same_v<T, bool>) {
+        append_flag(message, value);
+    } else if constexpr (std::is_same_v<T, unsigned int> || std::is_same_v<T, float>) {
+        message.push_back(MESSAGE_DELIMITER_SPACE);
+        append_number(message, value);
+    } else if constexpr (std::is_enum_v<T>) {
+        const char* token = nullptr;
+        if (!enum_to_string(value, token)) {
+            return false;
+        }
+        append_argument(message, token);
+    } else if constexpr (std::is_same_v<T, GsByIndex>) {
+        append_argument(message, GS_TARGET_BY_INDEX);
+        message.push_back(MESSAGE_DELIMITER_SPACE);
+        append_number(message, value.index);
+    } else if constexpr (std::is_same_v<T, GsByName>) {
+        append_argument(message, GS_TARGET_BY_NAME);
+        append_argument(message, value.name);
+    } else if constexpr (std::is_same_v<T, GsByQuotedName>) {
+        append_argument(message, GS_TARGET_BY_NAME);
+        append_quoted(message, value.name);
+    } else if constexpr (std::is_same_v<T, std::vector<GsCurvePoint>>) {
+        append_curve(message, value);
+    } else if constexpr (std::is_same_v<T, std::vector<GsDrawingData>>) {
+        /* "(t,x,y,p),(t,x,y,p),..." */
+        message.push_back(MESSAGE_DELIMITER_SPACE);
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            if (it != value.begin()) {
+                message.push_back(MESSAGE_DELIMITER_COMMA);
+            }
+            append_drawing_point(message, it->t, it->x, it->y, it->p);
+        }
+    } else if constexpr (std::is_same_v<T, GsDrawingBuffer>) {
+        const size_t count = value.t.size();
+        if ((value.x.size() != count) || (value.y.size() != count) || (value.p.size() != count)) {
+            /* 配列の長さがそろっていない */
+            return false;
+        }
+        message.push_back(MESSAGE_DELIMITER_SPACE);
+        for (size_t i = 0; i < count; i++) {
+            if (i != 0) {
+                message.push_back(MESSAGE_DELIMITER_COMMA);
+            }
+            append_drawing_point(message, value.t[i], value.x[i], value.y[i], value.p[i]);
+        }
+    } else if constexpr (std::is_same_v<T, std::vector<GsParameter>>) {
+        /* 書式の合わないパラメーターは読み飛ばす */
+        for (const auto& param : value) {
+            append_parameter(message, param);
+        }
+    } else {
+        append_argument(message, std::string_view(value));
+    }
+    return true;
+}
+
+static void append_argument(std::string& message, const std::string_view& text)
+{
+    message.push_back(MESSAGE_DELIMITER_SPACE);
+    message.append(text);
+}
+
+static void append_quoted(std::string& message, const std::string_view& text)
+{
+    message.push_back(MESSAGE_DELIMITER_SPACE);
+    message.push_back('"');
+    message.append(text);
+    message.push_back('"');
+}
+
+static void append_number(std::string& message, const unsigned int value)
+{
+    char buffer[NUMBER_BUFFER_SIZE];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    message.append(buffer, result.ptr);
+}
+
+static void append_number(std::string& message, const float value)
+{
+    /* ロケールに依存せず、読み戻すと同じ値になる最短の表記にする */
+    char buffer[NUMBER_BUFFER_SIZE];
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    message.append(buffer, result.ptr);
+#else
+    /* 浮動小数点数のto_charsが使えない処理系では、有効桁数9桁(floatの往復に十分な桁数)で出力する */
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    message.append(buffer, static_cast<size_t>(length));
+#endif
+}
+
+static void append_flag(std::string& message, const bool value)
+{
+    message.push_back(MESSAGE_DELIMITER_SPACE);
+    message.push_back((value == true) ? '1' : '0');
+}
+
+static void append_curve(std::string& message, const std::vector<GsCurvePoint>& curve)
+{
+    /* "(x,y),(x,y),..." */
+    message.push_back(MESSAGE_DELIMITER_SPACE);
+    message.push_back('"');
+    for (auto it = curve.begin(); it != curve.end(); ++it) {
+        if (it != curve.begin()) {
+            message.push_back(MESSAGE_DELIMITER_COMMA);
+        }
+        message.push_back('(');
+        append_number(message, it->x);
+        message.push_back(MESSAGE_DELIMITER_COMMA);
+        append_number(message, it->y);
+        message.push_back(')');
+    }
+    message.push_back('"');
+}
+
+static void append_drawing_point(std::string& message, const float t, const float x, const float y, const float p)
+{
+    /* "(t,x,y,p)" */
+    message.push_back('(');
+    append_number(message, t);
+    message.push_back(MESSAGE_DELIMITER_COMMA);
+    append_number(message, x);
+    message.push_back(MESSAGE_DELIMITER_COMMA);
+    append_number(message, y);
+    message.push_back(MESSAGE_DELIMITER_COMMA);
+    append_number(message, p);
+    message.push_back(')');
+}
+
+static bool append_parameter(std::string& message, const GsParameter& param)
+{
+    /* 書式の合わないパラメーターは何も追加せずにfalseを返す */
+    if (std::holds_alternative<GsNumber>(param)) {
+        /* 数値パラメーター {NUMBER, "Name", Type, "Unit", Min, Max, Def, Decimals} */
+        const GsNumber& gsNumber = std::get<GsNumber>(param);
+        const char* type = nullptr;
+        const char* sub_type = nullptr;
+        if (!enum_to_string(gsNumber.type, type)) {
+            return false;
+        }
+        if (!enum_to_string(gsNumber.sub_type, sub_type)) {
+            return false;
+        }
+        message.append(" {").append(type)
+            .append(",\"").append(gsNumber.name).append("\",").append(sub_type)
+            .append(",\"").append(gsNumber.unit).append("\",");
+        append_number(message, gsNumber.min_value);
+        message.push_back(MESSAGE_DELIMITER_COMMA);
+        append_number(message, gsNumber.max_value);
+        message.push_back(MESSAGE_DELIMITER_COMMA);
+        append_number(message, gsNumber.default_value);
+        message.push_back(MESSAGE_DELIMITER_COMMA);
+        append_number(message, gsNumber.decimals);
+        message.push_back('}');
+    } else if (std::holds_alternative<GsBool>(param)) {
+        /* 真偽値パラメーター {BOOL, "Name", Def} */
+        const GsBool& gsBool = std::get<GsBool>(param);
+        const char* type = nullptr;
+        if (!enum_to_string(gsBool.type, type)) {
+            return false;
+        }
+        message.append(" {").append(type)
+            .append(",\"").append(gsBool.name).append("\",")
+            .append((gsBool.default_value) ? "TRUE" : "FALSE").append("}");
+    } else if (std::holds_alternative<GsString>(param)) {
+        /* 文字列パラメーター {STRING, "Name", Type, "Def" */
+        const GsString& gsString = std::get<GsString>(param);
+        const char* type = nullptr;
+        const char* sub_type = nullptr;
+        if (!enum_to_string(gsString.type, type)) {
+            return false;
+        }
+        if (!enum_to_string(gsString.sub_type, sub_type)) {
+            return false;
+        }
+        message.append(" {").append(type)
+            .append(",\"").append(gsString.name).append("\",").append(sub_type)
+            .append(",\"").append(gsString.default_value).append("\"}");
+    } else if (std::holds_alternative<GsEnum>(param)) {
+        /* 列挙パラメーター {ENUM, "Name", Type, "[Choices]", Def} */
+        const GsEnum& gsEnum = std::get<GsEnum>(param);
+        const char* type = nullptr;
+        const char* sub_type = nullptr;
+        if (gsEnum.choices.size() == 0) {
+            return false;
+        }
+        if (!enum_to_string(gsEnum.type, type)) {
+            return false;
+        }
+        if (!enum_to_string(gsEnum.sub_type, sub_type)) {
+            return false;
+        }
+        message.append(" {").append(type)
+            .append(",\"").append(gsEnum.name).append("\",").append(sub_type).append(",\"");
+        for (auto it = gsEnum.choices.begin(); it != gsEnum.choices.end(); it++) {
+            if (it != gsEnum.choices.begin()) {
+                message.append(", ");
+            }
+            message.append(*it);
+        }
+        message.append("\",").append(gsEnum.choices.at(gsEnum.default_choice)).append("}");
+    } else if (std::holds_alternative<GsLabel>(param)) {
+        /* ラベルパラメーター {LABEL, "Text", Type, Alignment} */
+        const GsLabel& gsLabel = std::get<GsLabel>(param);
+        const char* type = nullptr;
+        const char* sub_type = nullptr;
+        const char* alignment = nullptr;
+        if (!enum_to_string(gsLabel.type, type)) {
+            return false;
+        }
+        if (!enum_to_string(gsLabel.sub_type, sub_type)) {
+            return false;
+        }
+        if (!enum_to_string(gsLabel.alignment, alignment)) {
+            return false;
+        }
+        message.append(" {").append(type)
+            .append(",\"").append(gsLabel.text).append("\",").append(sub_type)
+            .append(",").append(alignment).append("}");
+    }
+    return true;
+}
+
+static size_t split_fields(const std::string_view& text, const char delimiter, std::string_view* fields, const size_t max_fields)
+{
+    /* 要素の数を返す。fieldsにはmax_fieldsまで格納する */
+    gsapi_tokenizer tokenizer(text, delimiter);
+    std::string_view token;
+    size_t count = 0;
+    while (tokenizer.next(token)) {
+        if (count < max_fields) {
+            fields[count] = token;
+        }
+        count++;
+    }
+    return count;
+}
+
+static const char* skip_space(const char* first, const char* last)
+{
+    /* from_charsは先頭の空白を読み飛ばさないので、strtof/strtolに合わせて読み飛ばす */
+    while ((first != last) && (*first == MESSAGE_DELIMITER_SPACE)) {
+        first++;
+    }
+    return first;
+}
+
+static const char* parse_float(const char* first, const char* last, float& value)
+{
+    /* 読めた数値の直後を返す。読めなければnullptrを返し、値を変更しない */
+    first = skip_space(first, last);
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::from_chars(first, last, value);
+    return (result.ec == std::errc()) ? result.ptr : nullptr;
+#else
+    /* 浮動小数点数のfrom_charsが使えない処理系では、終端のある一時領域に写してstrtofで読む */
+    char buffer[NUMBER_BUFFER_SIZE];
+    const size_t length = std::min(static_cast<size_t>(last - first), sizeof(buffer) - 1);
+    std::memcpy(buffer, first, length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    const float parsed = std::strtof(buffer, &end);
+    if (end == buffer) {
+        return nullptr;
+    }
+    value = parsed;
+    return first + (end - buffer);
+#endif
+}
+
+template<size_t FIELD_COUNT, typename Store>
+static void parse_tuples(const std::string_view& text, Store store)
+{
+    /*
+     * (a,b,...),(a,b,...),... を先頭から1回だけ走査し、数値の組ごとにstore(values)を呼ぶ。
+     * 数値の数が合わない組や数値でない組は読み飛ばす。最後の組は閉じ括弧がなくてもよい。
+     */
+    const char* it = text.data();
+    const char* const last = it + text.size();
+    float values[FIELD_COUNT];
+    size_t count = 0;
+    TupleState state = TUPLE_STATE_BEGIN;
+    while (it != last) {
+        switch (state) {
+        case TUPLE_STATE_BEGIN:
+            if ((*it == MESSAGE_DELIMITER_COMMA) || (*it == MESSAGE_DELIMITER_SPACE) || (*it == '(') || (*it == '"')) {
+                it++;
+            } else {
+                count = 0;
+                state = TUPLE_STATE_FIELD;
+            }
+            break;
+        case TUPLE_STATE_FIELD: {
+            const char* end = parse_float(it, last, values[count]);
+            if (end == nullptr) {
+                state = TUPLE_STATE_SKIP;
+            } else {
+                it = end;
+                count++;
+                state = TUPLE_STATE_SEPARATOR;
+            }
+            break;
+        }
+        case TUPLE_STATE_SEPARATOR:
+            if ((*it == MESSAGE_DELIMITER_COMMA) && (count < FIELD_COUNT)) {
+                it++;
+                state = TUPLE_STATE_FIELD;
+            } else if ((*it == ')') && (count == FIELD_COUNT)) {
+                store(values);
+                it++;
+                state = TUPLE_STATE_BEGIN;
+            } else {
+                state = TUPLE_STATE_SKIP;
+            }
+            break;
+        case TUPLE_STATE_SKIP:
+        default: {
+            /* 次の閉じ括弧はmemchrでまとめて探す */
+            const void* close = std::memchr(it, ')', static_cast<size_t>(last - it));
+            it = (close != nullptr) ? static_cast<const char*>(close) + 1 : last;
+            state = TUPLE_STATE_BEGIN;
+            break;
+        }
+        }
+    }
+    if ((state == TUPLE_STATE_SEPARATOR) && (count == FIELD_COUNT)) {
+        store(values);
+    }
+}
+
+static bool string_to_float(const std::string_view& text, float& value)
+{
+    /* 応答が空(パイプライン中など)や数値でなければ値を変更しない */
+    float parsed = 0.f;
+    if (parse_float(text.data(), text.data() + text.size(), parsed) == nullptr) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+static bool string_to_int(const std::string_view& text, int& value)
+{
+    const char* last = text.data() + text.size();
+    const char* first = skip_space(text.data(), last);
+    int parsed = 0;
+    const auto result = std::from_chars(first, last, parsed);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+template<typename T>
+static bool enum_to_string(const T type, const char*& text)
+{
+    const auto& tokens = GsEnumTokens<T>::tokens;
+    const size_t index = static_cast<size_t>(type);
+    if (index >= std::size(tokens)) {
+        return false;
+    }
+    text = tokens[index];
+    return true;
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_tokenizer::gsapi_tokenizer(const std::string_view& text, const char delimiter)
+    : text(text)
+    , position(0)
+    , delimiter(delimiter)
+{
+}
+
+bool gsapi_tokenizer::next(std::string_view& token)
+{
+    if (position >= text.size()) {
+        return false;
+    }
+    size_t end = text.find(delimiter, position);
+    if (end == std::string_view::npos) {
+        end = text.size();
+    }
+    token = text.substr(position, end - position);
+    position = end + 1;
+    return true;
+}
+
+size_t gsapi_tokenizer::count() const
+{
+    if (position >= text.size()) {
+        return 0;
+    }
+    const auto first = text.begin() + position;
+    size_t tokens = static_cast<size_t>(std::count(first, text.end(), delimiter)) + 1;
+    if (text.back() == delimiter) {
+        /* 末尾の区切り文字の後ろは要素にしない */
+        tokens--;
+    }
+    return tokens;
+}
+
+bool gsapi_codec::encode_get_version(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_VERSION>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_commands(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_COMMANDS>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_models(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_MODELS>(delimiter, message);
+}
+
+bool gsapi_codec::encode_select_model(const std::string& model_name, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SELECT_MODEL>(delimiter, message, model_name);
+}
+
+bool gsapi_codec::encode_get_path(const std::string& path_name, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_PATH>(delimiter, message, path_name);
+}
+
+bool gsapi_codec::encode_get_samplerate(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_SAMPLERATE>(delimiter, message);
+}
+
+bool gsapi_codec::encode_set_samplerate(const std::string& samplerate, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_SAMPLERATE>(delimiter, message, samplerate);
+}
+
+bool gsapi_codec::encode_query_patchnames(const std::string& text, const bool name, const bool category, const bool tags,
+    const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_QUERY_PATCHNAMES>(delimiter, message, text, name, category, tags);
+}
+
+bool gsapi_codec::encode_query_patch(const std::string& patch_name, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_QUERY_PATCH>(delimiter, message, patch_name);
+}
+
+bool gsapi_codec::encode_query_categories(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_QUERY_CATEGORIES>(delimiter, message);
+}
+
+bool gsapi_codec::encode_query_tags(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_QUERY_TAGS>(delimiter, message);
+}
+
+bool gsapi_codec::encode_load_patch(const std::string& file_path, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_LOAD_PATCH>(delimiter, message, file_path);
+}
+
+bool gsapi_codec::encode_save_patch(const std::string& file_path, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SAVE_PATCH>(delimiter, message, file_path);
+}
+
+bool gsapi_codec::encode_render_patch(const std::string& file_path, const unsigned int depth,
+    const unsigned int channel, const unsigned int duration, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_RENDER_PATCH>(delimiter, message, file_path, depth, channel, duration);
+}
+
+bool gsapi_codec::encode_get_modelname(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_MODELNAME>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_patchname(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_PATCHNAME>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_variation(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_VARIATION>(delimiter, message);
+}
+
+bool gsapi_codec::encode_set_variation(const float& variation, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_VARIATION>(delimiter, message, variation);
+}
+
+bool gsapi_codec::encode_get_drawing(const unsigned int index, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_DRAWING>(delimiter, message, index);
+}
+
+bool gsapi_codec::encode_set_drawing(const std::vector<GsDrawingData>& drawing_data, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_DRAWING>(delimiter, message, drawing_data);
+}
+
+bool gsapi_codec::encode_set_drawing(const GsDrawingBuffer& drawing_buffer, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_DRAWING>(delimiter, message, drawing_buffer);
+}
+
+bool gsapi_codec::encode_get_metacount(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_METACOUNT>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_metanames(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_METANAMES>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_metaname(const unsigned int& index, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_METANAME>(delimiter, message, index);
+}
+
+bool gsapi_codec::encode_get_metavalue(const unsigned int& index, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_METAVALUE>(delimiter, message, GsByIndex{ index });
+}
+
+bool gsapi_codec::encode_get_metavalue(const std::string& name, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_METAVALUE>(delimiter, message, GsByName{ name });
+}
+
+bool gsapi_codec::encode_set_metavalue(const unsigned int& index, const float& metavalue, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_METAVALUE>(delimiter, message, GsByIndex{ index }, metavalue);
+}
+
+bool gsapi_codec::encode_set_metavalue(const std::string& name, const float& metavalue, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_METAVALUE>(delimiter, message, GsByName{ name }, metavalue);
+}
+
+bool gsapi_codec::encode_get_curvescount(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_CURVESCOUNT>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_curvenames(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_CURVENAMES>(delimiter, message);
+}
+
+bool gsapi_codec::encode_get_curvename(const unsigned int& curve_index, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_CURVENAME>(delimiter, message, curve_index);
+}
+
+bool gsapi_codec::encode_get_curvevalue(const unsigned int& curve_index, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_CURVEVALUE>(delimiter, message, GsByIndex{ curve_index });
+}
+
+bool gsapi_codec::encode_get_curvevalue(const std::string& curve_name, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_GET_CURVEVALUE>(delimiter, message, GsByQuotedName{ curve_name });
+}
+
+bool gsapi_codec::encode_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value,
+    const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_CURVEVALUE>(delimiter, message, GsByIndex{ curve_index },
+        curve_value.curve, curve_value.duration, curve_value.is_loop);
+}
+
+bool gsapi_codec::encode_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value,
+    const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_SET_CURVEVALUE>(delimiter, message, GsByQuotedName{ curve_name },
+        curve_value.curve, curve_value.duration, curve_value.is_loop);
+}
+
+bool gsapi_codec::encode_play(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_PLAY>(delimiter, message);
+}
+
+bool gsapi_codec::encode_stop(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_STOP>(delimiter, message);
+}
+
+bool gsapi_codec::encode_is_playing(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_IS_PLAYING>(delimiter, message);
+}
+
+bool gsapi_codec::encode_is_infinite(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_IS_INFINITE>(delimiter, message);
+}
+
+bool gsapi_codec::encode_is_randomized(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_IS_RANDOMIZED>(delimiter, message);
+}
+
+bool gsapi_codec::encode_enable_events(const bool is_notification, const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_ENABLE_EVENTS>(delimiter, message, is_notification);
+}
+
+bool gsapi_codec::encode_window_back(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_WINDOW_BACK>(delimiter, message);
+}
+
+bool gsapi_codec::encode_window_front(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_WINDOW_FRONT>(delimiter, message);
+}
+
+bool gsapi_codec::encode_window_message(const std::string& text, const GsWindowButton& button,
+    const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_WINDOW_MESSAGE>(delimiter, message, text, button);
+}
+
+bool gsapi_codec::encode_window_parameters(const std::vector<GsParameter>& params, const std::string& delimiter, std::string& message)
+{
+    if (params.size() == 0) {
+        return false;
+    }
+    return encode_command<GS_COMMAND_WINDOW_PARAMETERS>(delimiter, message, params);
+}
+
+bool gsapi_codec::encode_window_rendering(const bool& show_duration, const bool& show_variations,
+    const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_WINDOW_RENDERING>(delimiter, message, show_duration, show_variations);
+}
+
+bool gsapi_codec::encode_window_test(const std::string& delimiter, std::string& message)
+{
+    return encode_command<GS_COMMAND_WINDOW_TEST>(delimiter, message);
+}
+
+bool gsapi_codec::decode_text(const std::string_view& response, std::string& text)
+{
+    text = response;
+    return true;
+}
+
+bool gsapi_codec::decode_list(const std::string_view& response, std::vector<std::string>& list)
+{
+    gsapi_tokenizer tokenizer(response, MESSAGE_DELIMITER_COMMA);
+    list.reserve(list.size() + tokenizer.count());
+    std::string_view token;
+    while (tokenizer.next(token)) {
+        list.emplace_back(token);
+    }
+    return true;
+}
+
+bool gsapi_codec::decode_list(const std::string_view& response, std::vector<std::string_view>& list)
+{
+    gsapi_tokenizer tokenizer(response, MESSAGE_DELIMITER_COMMA);
+    list.reserve(list.size() + tokenizer.count());
+    std::string_view token;
+    while (tokenizer.next(token)) {
+        list.push_back(token);
+    }
+    return true;
+}
+
+bool gsapi_codec::decode_float(const std::string_view& response, float& value)
+{
+    return string_to_float(response, value);
+}
+
+bool gsapi_codec::decode_count(const std::string_view& response, unsigned int& count)
+{
+    int value = 0;
+    if (!string_to_int(response, value)) {
+        return false;
+    }
+    count = static_cast<unsigned int>(value);
+    return true;
+}
+
+bool gsapi_codec::decode_flag(const std::string_view& response, bool& flag)
+{
+    int value = 0;
+    if (!string_to_int(response, value)) {
+        return false;
+    }
+    flag = (value == 1) ? true : false;
+    return true;
+}
+
+bool gsapi_codec::decode_drawing(const std::string_view& response, std::vector<GsDrawingData>& drawing_data)
+{
+    /* スケッチパッドの曲線の情報をパースする。点の数は閉じ括弧の数で見積もる */
+    drawing_data.reserve(drawing_data.size() + static_cast<size_t>(std::count(response.begin(), response.end(), ')')));
+    parse_tuples<4>(response, [&drawing_data](const float* values) {
+        GsDrawingData drawing;
+        drawing.t = values[0];
+        drawing.x = values[1];
+        drawing.y = values[2];
+        drawing.p = values[3];
+        drawing_data.push_back(drawing);
+    });
+    return true;
+}
+
+bool gsapi_codec::decode_drawing(const std::string_view& response, GsDrawingBuffer& drawing_buffer)
+{
+    const size_t count = static_cast<size_t>(std::count(response.begin(), response.end(), ')'));
+    drawing_buffer.t.reserve(drawing_buffer.t.size() + count);
+    drawing_buffer.x.reserve(drawing_buffer.x.size() + count);
+    drawing_buffer.y.reserve(drawing_buffer.y.size() + count);
+    drawing_buffer.p.reserve(drawing_buffer.p.size() + count);
+    parse_tuples<4>(response, [&drawing_buffer](const float* values) {
+        drawing_buffer.t.push_back(values[0]);
+        drawing_buffer.x.push_back(values[1]);
+        drawing_buffer.y.push_back(values[2]);
+        drawing_buffer.p.push_back(values[3]);
+    });
+    return true;
+}
+
+bool gsapi_codec::decode_curvevalue(const std::string_view& response, GsCurveValue& curve_value)
+{
+    std::string_view curve_params[3];
+    if (split_fields(response, MESSAGE_DELIMITER_SPACE, curve_params, 3) != 3) {
+        /* 想定しているデータではない */
+        return false;
+    }
+    int is_loop = 0;
+    if (!string_to_float(curve_params[1], curve_value.duration) || !string_to_int(curve_params[2], is_loop)) {
+        return false;
+    }
+    curve_value.is_loop = (is_loop == 1) ? true : false;
+    /* オートメーションカーブの情報をパースする */
+    const std::string_view& curve = curve_params[0];
+    curve_value.curve.reserve(curve_value.curve.size() + static_cast<size_t>(std::count(curve.begin(), curve.end(), ')')));
+    parse_tuples<2>(curve, [&curve_value](const float* values) {
+        GsCurvePoint curve_point;
+        curve_point.x = values[0];
+        curve_point.y = values[1];
+        curve_value.curve.push_back(curve_point);
+    });
+    return true;
+}
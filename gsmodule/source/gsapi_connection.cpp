@@ -0,0 +1,316 @@
+﻿/****************************************************************
+ * @file    gsapi_connection.cpp
+ * @brief   ツールとのTCP接続を保持する
+ * @version 1.0.6
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_connection.h"
+#include "gsapi_socket.h"
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+/* ツールから受信するメッセージサイズ */
+#define RECEIVE_BUFFER_INITIAL_SIZE     (4096)
+#define MAX_RECEIVE_MESSAGE_SIZE        (64 * 1024 * 1024)
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_connection::gsapi_connection()
+    : sock(GS_INVALID_SOCKET)
+    , ip_address()
+    , port_number(0)
+    , connect_timeout_msec(0)
+    , send_timeout_msec(0)
+    , receive_timeout_msec(0)
+    , receive_buffer(RECEIVE_BUFFER_INITIAL_SIZE)
+    , receive_begin(0)
+    , receive_end(0)
+{
+}
+
+gsapi_connection::~gsapi_connection()
+{
+    close_socket();
+}
+
+bool gsapi_connection::startup()
+{
+#if (_WIN32)
+    /* WSAStartupはプロセスで一度だけ呼び、終了時にWSACleanupする */
+    struct winsock_session {
+        bool is_ready = false;
+        winsock_session() {
+            WSADATA wsaData;
+            is_ready = (WSAStartup(MAKEWORD(2, 2), &wsaData) == 0);
+            if (!is_ready) {
+                perror("[gsmodule]failed to call WSAStartup.\n");
+            }
+        }
+        ~winsock_session() {
+            if (is_ready) {
+                WSACleanup();
+            }
+        }
+    };
+    static winsock_session session;
+    return session.is_ready;
+#else
+    return true;
+#endif
+}
+
+void gsapi_connection::set_endpoint(const std::string& ip_address, const unsigned int port_number)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (this->ip_address == ip_address && this->port_number == port_number) {
+        return;
+    }
+    close_socket();
+    this->ip_address = ip_address;
+    this->port_number = port_number;
+}
+
+void gsapi_connection::set_timeout(const unsigned int connect_timeout_msec,
+    const unsigned int send_timeout_msec, const unsigned int receive_timeout_msec)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->connect_timeout_msec = connect_timeout_msec;
+    this->send_timeout_msec = send_timeout_msec;
+    this->receive_timeout_msec = receive_timeout_msec;
+}
+
+void gsapi_connection::disconnect()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    close_socket();
+}
+
+bool gsapi_connection::is_connected() const
+{
+    return sock != GS_INVALID_SOCKET;
+}
+
+bool gsapi_connection::send_command(const std::string& message, const std::string& delimiter, std::string_view& response)
+{
+    bool is_replied = false;
+    return send_command(message, delimiter, response, is_replied);
+}
+
+bool gsapi_connection::send_command(const std::string& message, const std::string& delimiter,
+    std::string_view& response, bool& is_replied)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    response = std::string_view();
+    is_replied = false;
+
+    if (!send_with_reconnect(message)) {
+        return false;
+    }
+    size_t offset = 0;
+    size_t length = 0;
+    if (!receive_message(delimiter, offset, length)) {
+        /* 遅れて届いた応答が次のコマンドに混ざらないよう接続を閉じる */
+        close_socket();
+        return true;
+    }
+    response = std::string_view(receive_buffer.data() + offset, length);
+    is_replied = true;
+    return true;
+}
+
+bool gsapi_connection::send_pipeline(const std::string& messages, const size_t count,
+    const std::string& delimiter, std::vector<std::string_view>& responses)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    responses.clear();
+
+    if (!send_with_reconnect(messages)) {
+        return false;
+    }
+    /* 応答は送信した順に届く。バッファの拡張で位置がずれないよう、まず位置だけを記録する */
+    frames.clear();
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = 0;
+        size_t length = 0;
+        if (!receive_message(delimiter, offset, length)) {
+            close_socket();
+            return false;
+        }
+        frames.emplace_back(offset, length);
+    }
+    for (const auto& frame : frames) {
+        responses.emplace_back(receive_buffer.data() + frame.first, frame.second);
+    }
+    return true;
+}
+
+bool gsapi_connection::send_with_reconnect(const std::string& message)
+{
+    /* 前の応答の後ろに残っているデータは要求していないので読み捨てる */
+    receive_begin = 0;
+    receive_end = 0;
+
+    /* 相手が切断していれば、送信前に接続し直す */
+    if (is_connected() && !is_alive()) {
+        close_socket();
+    }
+    const bool is_reused = is_connected();
+    if (!is_reused && !connect_to_endpoint()) {
+        return false;
+    }
+    size_t sent_size = 0;
+    if (send_message(message, sent_size)) {
+        return true;
+    }
+    close_socket();
+    if (!is_reused || (sent_size > 0)) {
+        /* 一部でも届いていれば、送り直すと先頭のコマンドがツールで2回実行される */
+        perror("[gsmodule]failed to send message.\n");
+        return false;
+    }
+    /* 再利用した接続が1バイトも送れなかったときだけ、切れていたとみなして一度だけ再接続する */
+    if (!connect_to_endpoint()) {
+        return false;
+    }
+    if (!send_message(message, sent_size)) {
+        perror("[gsmodule]failed to send message.\n");
+        close_socket();
+        return false;
+    }
+    return true;
+}
+
+bool gsapi_connection::connect_to_endpoint()
+{
+    sock = open_socket(ip_address, port_number, connect_timeout_msec);
+    return sock != GS_INVALID_SOCKET;
+}
+
+bool gsapi_connection::is_alive() const
+{
+    /* 読み込み可能なら、切断通知か前の応答の残りが届いている */
+    pollfd pfd = {};
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    const int result = GS_POLL(&pfd, 1, 0);
+    if (result == 0) {
+        return true;
+    }
+    return false;
+}
+
+bool gsapi_connection::send_message(const std::string& message, size_t& total_sent)
+{
+    /* メッセージ全体が送られるようにする */
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(send_timeout_msec);
+    total_sent = 0;
+    const size_t message_len = message.size();
+    while (total_sent < message_len) {
+        const int sent = static_cast<int>(send(sock, message.c_str() + total_sent,
+            static_cast<int>(message_len - total_sent), GS_SEND_FLAGS));
+        if (sent < 0) {
+            if (is_interrupted()) {
+                // シグナルによる中断。再試行
+                continue;
+            }
+            if (!is_would_block()) {
+                return false;
+            }
+            /* 送信バッファが空くまで待つ。その間に届いた応答は読み進め、相手の送信が詰まらないようにする */
+            const short revents = wait_ready(sock, POLLOUT | POLLIN, deadline);
+            if (revents == 0) {
+                return false;
+            }
+            if ((revents & POLLIN) && (receive_some() < 0)) {
+                return false;
+            }
+            continue;
+        }
+        total_sent += static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool gsapi_connection::receive_message(const std::string& delimiter, size_t& offset, size_t& length)
+{
+    if (delimiter.empty()) {
+        return false;
+    }
+
+    /* デリミタが見つかるまで受信バッファに追記する */
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(receive_timeout_msec);
+    size_t search_from = 0;
+    while (1) {
+        const std::string_view received(receive_buffer.data() + receive_begin, receive_end - receive_begin);
+        const size_t found = received.find(delimiter, search_from);
+        if (found != std::string_view::npos) {
+            offset = receive_begin;
+            length = found;
+            receive_begin += found + delimiter.size();
+            return true;
+        }
+        /* 次回はデリミタが分割されて届いた場合に備えて少し手前から探す */
+        search_from = (received.size() >= delimiter.size()) ? (received.size() - delimiter.size() + 1) : 0;
+
+        const int len = receive_some();
+        if (len < 0) {
+            return false;
+        }
+        if (len == 0) {
+            /* データが届いた時点で起きる。期限までに届かなければ諦める */
+            if (wait_ready(sock, POLLIN, deadline) == 0) {
+                perror("[gsmodule]failed to receive message due to timeout.");
+                return false;
+            }
+        }
+    }
+}
+
+int gsapi_connection::receive_some()
+{
+    /* バッファが埋まっていれば拡張する */
+    if (receive_end == receive_buffer.size()) {
+        if (receive_buffer.size() >= MAX_RECEIVE_MESSAGE_SIZE) {
+            perror("[gsmodule]received message is too large.");
+            return -1;
+        }
+        receive_buffer.resize(receive_buffer.size() * 2);
+    }
+
+    while (1) {
+        const int len = static_cast<int>(recv(sock, receive_buffer.data() + receive_end,
+            static_cast<int>(receive_buffer.size() - receive_end), 0));
+        if (len > 0) {
+            receive_end += static_cast<size_t>(len);
+            return len;
+        }
+        if (len == 0) {
+            perror("[gsmodule]connection closed by peer.");
+            return -1;
+        }
+        if (is_interrupted()) {
+            continue;
+        }
+        if (is_would_block()) {
+            return 0;
+        }
+        perror("[gsmodule]failed to receive message.");
+        return -1;
+    }
+}
+
+void gsapi_connection::close_socket()
+{
+    if (sock != GS_INVALID_SOCKET) {
+        GS_CLOSE_SOCKET(sock);
+        sock = GS_INVALID_SOCKET;
+    }
+    receive_begin = 0;
+    receive_end = 0;
+}
@@ -0,0 +1,145 @@
+﻿/****************************************************************
+ * @file    gsapi_curve.cpp
+ * @brief   オートメーションカーブの点を減らす
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_curve.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 誤差を調べた区間 */
+typedef struct GsCurveSegmentStruct {
+    size_t  first = 0;                                                          /* 区間の始点の番号 */
+    size_t  last = 0;                                                           /* 区間の終点の番号 */
+    size_t  farthest = 0;                                                       /* 線分から最も離れた点の番号 */
+    float   error = 0.f;                                                        /* その点と線分の距離 */
+
+    bool operator<(const GsCurveSegmentStruct& other) const { return error < other.error; }
+} GsCurveSegment;
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static void segment_errors(const GsCurvePoint* points, const size_t count,
+    const GsCurvePoint& begin, const GsCurvePoint& end, float* errors);
+static GsCurveSegment measure_segment(const std::vector<GsCurvePoint>& points, const size_t first, const size_t last,
+    std::vector<float>& errors);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static void segment_errors(const GsCurvePoint* points, const size_t count,
+    const GsCurvePoint& begin, const GsCurvePoint& end, float* errors)
+{
+    /*
+     * 各点と線分(begin, end)を通る直線の距離に比例する値(外積の絶対値)を求める。
+     * 分岐のない単純なループにして、コンパイラのベクトル化に任せる。
+     */
+    const float dx = end.x - begin.x;
+    const float dy = end.y - begin.y;
+    if ((dx == 0.f) && (dy == 0.f)) {
+        /* 始点と終点が同じ位置なら、始点からの距離の2乗 */
+        for (size_t i = 0; i < count; i++) {
+            const float px = points[i].x - begin.x;
+            const float py = points[i].y - begin.y;
+            errors[i] = px * px + py * py;
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        errors[i] = std::fabs((points[i].x - begin.x) * dy - (points[i].y - begin.y) * dx);
+    }
+}
+
+static GsCurveSegment measure_segment(const std::vector<GsCurvePoint>& points, const size_t first, const size_t last,
+    std::vector<float>& errors)
+{
+    GsCurveSegment segment;
+    segment.first = first;
+    segment.last = last;
+    if (last <= first + 1) {
+        /* 間に点がない */
+        return segment;
+    }
+    const size_t count = last - first - 1;
+    const GsCurvePoint& begin = points[first];
+    const GsCurvePoint& end = points[last];
+    segment_errors(points.data() + first + 1, count, begin, end, errors.data());
+    const size_t offset = static_cast<size_t>(std::max_element(errors.begin(), errors.begin() + count) - errors.begin());
+    segment.farthest = first + 1 + offset;
+
+    /* 比較用の値を距離に直すのは最大の点だけでよい */
+    const float dx = end.x - begin.x;
+    const float dy = end.y - begin.y;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    segment.error = (length > 0.f) ? (errors[offset] / length) : std::sqrt(errors[offset]);
+    return segment;
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+bool gsapi_curve::simplify(const std::vector<GsCurvePoint>& source, const float max_error,
+    const unsigned int max_points, std::vector<GsCurvePoint>& destination)
+{
+    const size_t count = source.size();
+    const size_t budget = (max_points == 0) ? count : std::max<size_t>(max_points, 2);
+    destination.clear();
+    if ((count <= 2) || ((max_error <= 0.f) && (budget >= count))) {
+        /* 減らす点がないか、減らす指定がない */
+        destination.assign(source.begin(), source.end());
+        return true;
+    }
+
+    /* 誤差が大きい区間から順に分け、分けた点を残す */
+    std::vector<float> errors(count);
+    std::vector<char> is_kept(count, 0);
+    is_kept[0] = 1;
+    is_kept[count - 1] = 1;
+    size_t kept = 2;
+    std::priority_queue<GsCurveSegment> segments;
+    segments.push(measure_segment(source, 0, count - 1, errors));
+    while (!segments.empty() && (kept < budget)) {
+        const GsCurveSegment segment = segments.top();
+        segments.pop();
+        if (segment.last <= segment.first + 1) {
+            continue;
+        }
+        if (segment.error <= std::max(max_error, 0.f)) {
+            /* 残りの区間はすべて許容誤差に収まっている */
+            break;
+        }
+        is_kept[segment.farthest] = 1;
+        kept++;
+        segments.push(measure_segment(source, segment.first, segment.farthest, errors));
+        segments.push(measure_segment(source, segment.farthest, segment.last, errors));
+    }
+
+    destination.reserve(kept);
+    for (size_t i = 0; i < count; i++) {
+        if (is_kept[i] != 0) {
+            destination.push_back(source[i]);
+        }
+    }
+    return true;
+}
+
+const GsCurveValue& gsapi_curve::prepare(const GsCurveValue& curve_value, const GsApiClientConfig& config, GsCurveValue& work)
+{
+    if ((config.curve_max_error <= 0.f) && (config.curve_max_points == 0)) {
+        return curve_value;
+    }
+    simplify(curve_value.curve, config.curve_max_error, config.curve_max_points, work.curve);
+    work.duration = curve_value.duration;
+    work.is_loop = curve_value.is_loop;
+    return work;
+}
@@ -0,0 +1,182 @@
+﻿/****************************************************************
+ * @file    gsapi_curve_state.cpp
+ * @brief   送信したオートメーションカーブを覚え、変わった曲線だけを送る
+ * @version 1.0.1
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_curve_state.h"
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static size_t hash_bytes(size_t seed, const void* data, const size_t size);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static size_t hash_bytes(size_t seed, const void* data, const size_t size)
+{
+    /* FNV-1a */
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t value = static_cast<uint64_t>(seed);
+    for (size_t i = 0; i < size; i++) {
+        value ^= bytes[i];
+        value *= 1099511628211ull;
+    }
+    return static_cast<size_t>(value);
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_curve_state::gsapi_curve_state(gsapi_session& session) :
+    session(session),
+    entries(),
+    flush_buffer(),
+    failed_indices(),
+    mutex()
+{
+}
+
+bool gsapi_curve_state::stage(const GsTarget& target, const GsCurveValue& curve_value)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t value_hash = hash(curve_value);
+    GsCurveStateEntry& entry = entries[target];
+    if (is_sent(entry, curve_value, value_hash)) {
+        /* 送った曲線に戻したなら、溜めた変更も要らない */
+        entry.is_dirty = false;
+        entry.pending.curve.clear();
+        return false;
+    }
+    entry.pending.curve.assign(curve_value.curve.begin(), curve_value.curve.end());
+    entry.pending.duration = curve_value.duration;
+    entry.pending.is_loop = curve_value.is_loop;
+    entry.pending_hash = value_hash;
+    entry.is_dirty = true;
+    return true;
+}
+
+bool gsapi_curve_state::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    flush_buffer.clear();
+    for (auto& [target, entry] : entries) {
+        if (entry.is_dirty) {
+            GsCurveValueEntry value_entry;
+            value_entry.target = target;
+            value_entry.value = entry.pending;
+            flush_buffer.push_back(std::move(value_entry));
+        }
+    }
+    if (flush_buffer.empty()) {
+        return true;
+    }
+    const bool result = session.command_set_curvevalues(flush_buffer, failed_indices);
+    /* flush_bufferはentriesの順に作ったので、同じ順にたどって結果を反映する */
+    size_t index = 0;
+    auto failed = failed_indices.begin();
+    for (auto& [target, entry] : entries) {
+        if (!entry.is_dirty) {
+            continue;
+        }
+        const bool is_failed = (failed != failed_indices.end()) && (*failed == index);
+        if (is_failed) {
+            failed++;
+        }
+        index++;
+        if (is_failed) {
+            /* 送る前に失敗した曲線(パッチにない名前など)は何度送っても失敗するので捨てる */
+            entry.is_dirty = false;
+            entry.pending.curve.clear();
+        } else if (!result) {
+            /* 一部だけ設定されたかもしれず、ツール側の曲線がわからなくなったので、次は必ず送る */
+            entry.is_sent = false;
+        } else {
+            std::swap(entry.sent, entry.pending);
+            entry.sent_hash = entry.pending_hash;
+            entry.is_sent = true;
+            entry.is_dirty = false;
+            entry.pending.curve.clear();
+        }
+    }
+    return result && failed_indices.empty();
+}
+
+bool gsapi_curve_state::command_set_curvevalue(const GsTarget& target, const GsCurveValue& curve_value)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t value_hash = hash(curve_value);
+    GsCurveStateEntry& entry = entries[target];
+    if (is_sent(entry, curve_value, value_hash)) {
+        entry.is_dirty = false;
+        return true;
+    }
+    bool result = false;
+    if (std::holds_alternative<unsigned int>(target)) {
+        result = session.command_set_curvevalue(std::get<unsigned int>(target), curve_value);
+    } else {
+        result = session.command_set_curvevalue(std::get<std::string>(target), curve_value);
+    }
+    if (!result) {
+        /* ツール側の曲線がわからなくなったので、次は必ず送る */
+        entry.is_sent = false;
+        return false;
+    }
+    entry.sent.curve.assign(curve_value.curve.begin(), curve_value.curve.end());
+    entry.sent.duration = curve_value.duration;
+    entry.sent.is_loop = curve_value.is_loop;
+    entry.sent_hash = value_hash;
+    entry.is_sent = true;
+    entry.is_dirty = false;
+    return true;
+}
+
+size_t gsapi_curve_state::dirty_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto& [target, entry] : entries) {
+        if (entry.is_dirty) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void gsapi_curve_state::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+size_t gsapi_curve_state::hash(const GsCurveValue& curve_value)
+{
+    size_t value = static_cast<size_t>(14695981039346656037ull);
+    value = hash_bytes(value, curve_value.curve.data(), curve_value.curve.size() * sizeof(GsCurvePoint));
+    value = hash_bytes(value, &curve_value.duration, sizeof(curve_value.duration));
+    const unsigned char is_loop = curve_value.is_loop ? 1 : 0;
+    value = hash_bytes(value, &is_loop, sizeof(is_loop));
+    return value;
+}
+
+bool gsapi_curve_state::is_same(const GsCurveValue& left, const GsCurveValue& right)
+{
+    if ((left.curve.size() != right.curve.size()) || (left.duration != right.duration) || (left.is_loop != right.is_loop)) {
+        return false;
+    }
+    return std::memcmp(left.curve.data(), right.curve.data(), left.curve.size() * sizeof(GsCurvePoint)) == 0;
+}
+
+bool gsapi_curve_state::is_sent(const GsCurveStateEntry& entry, const GsCurveValue& curve_value, const size_t value_hash) const
+{
+    /* ハッシュ値が違えば比べるまでもない。同じなら衝突を考えて中身も比べる */
+    return entry.is_sent && (entry.sent_hash == value_hash) && is_same(entry.sent, curve_value);
+}
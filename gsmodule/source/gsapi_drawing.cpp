@@ -0,0 +1,163 @@
+﻿/****************************************************************
+ * @file    gsapi_drawing.cpp
+ * @brief   スケッチパッドの曲線を要素ごとの配列で保持し、まとめて加工する
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_drawing.h"
+#include <algorithm>
+#include <cmath>
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static void fit_range(float* values, const size_t size, const float center);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static void fit_range(float* values, const size_t size, const float center)
+{
+    /* 最小値と最大値を求めてから[0…1]に広げる。幅がなければcenterにそろえる */
+    float min_value = values[0];
+    float max_value = values[0];
+    for (size_t i = 1; i < size; i++) {
+        min_value = std::min(min_value, values[i]);
+        max_value = std::max(max_value, values[i]);
+    }
+    const float range = max_value - min_value;
+    if (range <= 0.f) {
+        std::fill(values, values + size, center);
+        return;
+    }
+    const float scale = 1.f / range;
+    for (size_t i = 0; i < size; i++) {
+        values[i] = (values[i] - min_value) * scale;
+    }
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+size_t gsapi_drawing::size(const GsDrawingBuffer& buffer)
+{
+    return std::min(std::min(buffer.t.size(), buffer.x.size()), std::min(buffer.y.size(), buffer.p.size()));
+}
+
+bool gsapi_drawing::resize(GsDrawingBuffer& buffer, const size_t size)
+{
+    buffer.t.resize(size);
+    buffer.x.resize(size);
+    buffer.y.resize(size);
+    buffer.p.resize(size);
+    return true;
+}
+
+bool gsapi_drawing::from_points(const std::vector<GsDrawingData>& drawing_data, GsDrawingBuffer& buffer)
+{
+    const size_t count = drawing_data.size();
+    resize(buffer, count);
+    for (size_t i = 0; i < count; i++) {
+        buffer.t[i] = drawing_data[i].t;
+        buffer.x[i] = drawing_data[i].x;
+        buffer.y[i] = drawing_data[i].y;
+        buffer.p[i] = drawing_data[i].p;
+    }
+    return true;
+}
+
+bool gsapi_drawing::to_points(const GsDrawingBuffer& buffer, std::vector<GsDrawingData>& drawing_data)
+{
+    const size_t count = size(buffer);
+    drawing_data.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        drawing_data[i].t = buffer.t[i];
+        drawing_data[i].x = buffer.x[i];
+        drawing_data[i].y = buffer.y[i];
+        drawing_data[i].p = buffer.p[i];
+    }
+    return true;
+}
+
+bool gsapi_drawing::scale_time(GsDrawingBuffer& buffer, const float scale, const float offset)
+{
+    float* t = buffer.t.data();
+    const size_t count = buffer.t.size();
+    for (size_t i = 0; i < count; i++) {
+        t[i] = t[i] * scale + offset;
+    }
+    return true;
+}
+
+bool gsapi_drawing::normalize(GsDrawingBuffer& buffer)
+{
+    const size_t count = size(buffer);
+    if (count == 0) {
+        return false;
+    }
+    /* 時間は先頭の点を0秒にする(昇順に並んでいなくても最小値を基準にする) */
+    const float begin = *std::min_element(buffer.t.begin(), buffer.t.begin() + count);
+    scale_time(buffer, 1.f, -begin);
+    fit_range(buffer.x.data(), count, 0.5f);
+    fit_range(buffer.y.data(), count, 0.5f);
+    return true;
+}
+
+bool gsapi_drawing::apply_pressure_curve(GsDrawingBuffer& buffer, const float gamma)
+{
+    if (!(gamma > 0.f)) {
+        return false;
+    }
+    float* p = buffer.p.data();
+    const size_t count = buffer.p.size();
+    if (gamma == 1.f) {
+        for (size_t i = 0; i < count; i++) {
+            p[i] = std::min(std::max(p[i], 0.f), 1.f);
+        }
+        return true;
+    }
+    for (size_t i = 0; i < count; i++) {
+        p[i] = std::pow(std::min(std::max(p[i], 0.f), 1.f), gamma);
+    }
+    return true;
+}
+
+bool gsapi_drawing::resample(const GsDrawingBuffer& source, const float rate, GsDrawingBuffer& destination)
+{
+    const size_t count = size(source);
+    if ((count == 0) || !(rate > 0.f)) {
+        return false;
+    }
+    const float begin = source.t[0];
+    const float duration = std::max(source.t[count - 1] - begin, 0.f);
+    const size_t sample_count = static_cast<size_t>(std::floor(duration * rate)) + 1;
+    resize(destination, sample_count);
+
+    /* 出力の時刻は一定間隔なので、入力の区間を先頭から1回だけたどる */
+    const float interval = 1.f / rate;
+    size_t segment = 0;
+    for (size_t i = 0; i < sample_count; i++) {
+        const float time = begin + static_cast<float>(i) * interval;
+        while ((segment + 2 < count) && (source.t[segment + 1] <= time)) {
+            segment++;
+        }
+        destination.t[i] = time;
+        if (count == 1) {
+            destination.x[i] = source.x[0];
+            destination.y[i] = source.y[0];
+            destination.p[i] = source.p[0];
+            continue;
+        }
+        const float t0 = source.t[segment];
+        const float t1 = source.t[segment + 1];
+        const float ratio = (t1 > t0) ? std::min(std::max((time - t0) / (t1 - t0), 0.f), 1.f) : 0.f;
+        destination.x[i] = source.x[segment] + (source.x[segment + 1] - source.x[segment]) * ratio;
+        destination.y[i] = source.y[segment] + (source.y[segment + 1] - source.y[segment]) * ratio;
+        destination.p[i] = source.p[segment] + (source.p[segment + 1] - source.p[segment]) * ratio;
+    }
+    return true;
+}
@@ -0,0 +1,164 @@
+﻿/****************************************************************
+ * @file    gsapi_meta_coalescer.cpp
+ * @brief   メタパラメータの設定をまとめ、最新の値だけを一定の頻度で送る
+ * @version 1.0.1
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_meta_coalescer.h"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define META_COALESCER_MAX_RETRY_MSEC   (1000)                                  /* 送れなかったときに送り直す最長の間隔 [ミリ秒] */
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_meta_coalescer::gsapi_meta_coalescer(gsapi_session& session)
+    : session(session)
+    , pending()
+    , mutex()
+    , condition()
+    , send_mutex()
+    , send_values()
+    , failed_indices()
+    , flush_thread()
+    , running(false)
+    , interval()
+{
+}
+
+gsapi_meta_coalescer::~gsapi_meta_coalescer()
+{
+    stop();
+}
+
+bool gsapi_meta_coalescer::start(const unsigned int rate)
+{
+    if ((rate == 0) || running || flush_thread.joinable()) {
+        return false;
+    }
+    interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    running = true;
+    flush_thread = std::thread(&gsapi_meta_coalescer::run, this);
+    return true;
+}
+
+void gsapi_meta_coalescer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    condition.notify_all();
+    if (flush_thread.joinable()) {
+        flush_thread.join();
+    }
+    flush();
+}
+
+void gsapi_meta_coalescer::command_set_metavalue(const GsTarget& target, const float metavalue)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending[target] = metavalue;
+    }
+    condition.notify_one();
+}
+
+bool gsapi_meta_coalescer::flush()
+{
+    size_t dropped_count = 0;
+    return send_pending(dropped_count) && (dropped_count == 0);
+}
+
+size_t gsapi_meta_coalescer::pending_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+bool gsapi_meta_coalescer::send_pending(size_t& dropped_count)
+{
+    std::lock_guard<std::mutex> send_lock(send_mutex);
+    dropped_count = 0;
+    send_values.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [target, metavalue] : pending) {
+            GsMetaValueEntry entry;
+            entry.target = target;
+            entry.value = metavalue;
+            send_values.push_back(std::move(entry));
+        }
+        pending.clear();
+    }
+    if (send_values.empty()) {
+        return true;
+    }
+    const bool result = session.command_set_metavalues(send_values, failed_indices);
+    /* 送る前に失敗した値(パッチにない名前など)は何度送っても失敗するので捨てる */
+    dropped_count = failed_indices.size();
+    if (result) {
+        return true;
+    }
+    /* 通信に失敗した値は、その後に新しい値が来ていなければ戻しておく */
+    std::lock_guard<std::mutex> lock(mutex);
+    auto failed = failed_indices.begin();
+    for (size_t i = 0; i < send_values.size(); i++) {
+        if ((failed != failed_indices.end()) && (*failed == i)) {
+            failed++;
+            continue;
+        }
+        pending.try_emplace(send_values[i].target, send_values[i].value);
+    }
+    return false;
+}
+
+void gsapi_meta_coalescer::run()
+{
+    const std::chrono::steady_clock::duration max_retry_interval = std::max<std::chrono::steady_clock::duration>(
+        interval, std::chrono::milliseconds(META_COALESCER_MAX_RETRY_MSEC));
+    std::chrono::steady_clock::duration retry_interval = interval;
+    std::chrono::steady_clock::time_point next_send = std::chrono::steady_clock::now();
+    bool is_failing = false;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            /* 値が来るまで待ち、来たら前回の送信から最短間隔が過ぎるまで値を溜める */
+            condition.wait(lock, [this] { return !running || !pending.empty(); });
+            if (!running) {
+                break;
+            }
+            if (condition.wait_until(lock, next_send, [this] { return !running; })) {
+                break;
+            }
+        }
+        size_t dropped_count = 0;
+        const bool result = send_pending(dropped_count);
+        if (result) {
+            retry_interval = interval;
+        } else {
+            /* ツールが応答しない間は、送り直す間隔を倍にしていく */
+            retry_interval = std::min(retry_interval * 2, max_retry_interval);
+        }
+        next_send = std::chrono::steady_clock::now() + retry_interval;
+        /* 失敗が続く間は、最初の1回だけ知らせる */
+        const bool is_failed = !result || (dropped_count > 0);
+        if (is_failed && !is_failing) {
+            if (!result) {
+                perror("[gsmodule]failed to send metavalues.\n");
+            } else {
+                perror("[gsmodule]dropped metavalues that cannot be sent.\n");
+            }
+        }
+        is_failing = is_failed;
+    }
+}
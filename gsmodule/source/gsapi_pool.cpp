@@ -0,0 +1,273 @@
+﻿/****************************************************************
+ * @file    gsapi_pool.cpp
+ * @brief   複数のツールへの接続を保持し、貸し出す
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_pool.h"
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_lease::gsapi_lease()
+    : pool(nullptr)
+    , index(0)
+    , session(nullptr)
+    , endpoint(0)
+{
+}
+
+gsapi_lease::gsapi_lease(gsapi_pool* pool, const size_t index, gsapi_session* session, const size_t endpoint)
+    : pool(pool)
+    , index(index)
+    , session(session)
+    , endpoint(endpoint)
+{
+}
+
+gsapi_lease::~gsapi_lease()
+{
+    release();
+}
+
+gsapi_lease::gsapi_lease(gsapi_lease&& other) noexcept
+    : pool(other.pool)
+    , index(other.index)
+    , session(other.session)
+    , endpoint(other.endpoint)
+{
+    other.pool = nullptr;
+    other.session = nullptr;
+}
+
+gsapi_lease& gsapi_lease::operator=(gsapi_lease&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        index = other.index;
+        session = other.session;
+        endpoint = other.endpoint;
+        other.pool = nullptr;
+        other.session = nullptr;
+    }
+    return *this;
+}
+
+bool gsapi_lease::is_valid() const
+{
+    return session != nullptr;
+}
+
+size_t gsapi_lease::get_endpoint() const
+{
+    return endpoint;
+}
+
+void gsapi_lease::release()
+{
+    if (pool != nullptr) {
+        pool->give_back(index, true);
+    }
+    pool = nullptr;
+    session = nullptr;
+}
+
+void gsapi_lease::invalidate()
+{
+    if (pool != nullptr) {
+        pool->give_back(index, false);
+    }
+    pool = nullptr;
+    session = nullptr;
+}
+
+gsapi_session& gsapi_lease::operator*() const
+{
+    return *session;
+}
+
+gsapi_session* gsapi_lease::operator->() const
+{
+    return session;
+}
+
+gsapi_pool::gsapi_pool()
+    : config()
+    , entries()
+    , next_index(0)
+{
+}
+
+gsapi_pool::~gsapi_pool()
+{
+    close();
+}
+
+bool gsapi_pool::open(const GsApiPoolConfig& config)
+{
+    close();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->config = config;
+        for (size_t endpoint = 0; endpoint < config.endpoints.size(); endpoint++) {
+            for (unsigned int i = 0; i < config.connections_per_endpoint; i++) {
+                GsPoolEntry entry;
+                entry.session = std::make_unique<gsapi_session>(config.endpoints[endpoint]);
+                entry.endpoint = endpoint;
+                entries.push_back(std::move(entry));
+            }
+        }
+        next_index = 0;
+    }
+
+    /* 最初の貸し出しを待たせないよう、ここで接続しておく(未確認の接続はすべて確認対象) */
+    return check_idle() > 0;
+}
+
+void gsapi_pool::close()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() {
+        for (const auto& entry : entries) {
+            if (entry.is_leased) {
+                return false;
+            }
+        }
+        return true;
+    });
+    entries.clear();
+    next_index = 0;
+}
+
+bool gsapi_pool::acquire(gsapi_lease& lease)
+{
+    return acquire_from(true, 0, lease);
+}
+
+bool gsapi_pool::acquire(const size_t endpoint, gsapi_lease& lease)
+{
+    return acquire_from(false, endpoint, lease);
+}
+
+size_t gsapi_pool::check_idle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (size_t index = 0; index < entries.size(); index++) {
+        GsPoolEntry& entry = entries[index];
+        if (entry.is_leased || !is_stale(entry, std::chrono::steady_clock::now())) {
+            continue;
+        }
+        /* 確認中は貸し出さない */
+        entry.is_leased = true;
+        gsapi_session* session = entry.session.get();
+        lock.unlock();
+        const bool is_healthy = session->is_connect();
+        lock.lock();
+        entry.is_leased = false;
+        entry.is_healthy = is_healthy;
+        entry.last_checked = std::chrono::steady_clock::now();
+        condition.notify_all();
+    }
+    size_t healthy_count = 0;
+    for (const auto& entry : entries) {
+        if (entry.is_healthy) {
+            healthy_count++;
+        }
+    }
+    return healthy_count;
+}
+
+bool gsapi_pool::acquire_from(const bool is_any, const size_t endpoint, gsapi_lease& lease)
+{
+    lease.release();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.acquire_timeout_msec);
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<bool> is_tried(entries.size(), false);
+    while (1) {
+        /* 空いている接続を探す。前回使えた接続を優先し、確認に失敗した接続は再び試さない */
+        const size_t count = entries.size();
+        size_t found = count;
+        size_t fallback = count;
+        bool is_waitable = false;
+        for (size_t i = 0; i < count; i++) {
+            const size_t index = (next_index + i) % count;
+            const GsPoolEntry& entry = entries[index];
+            if (!is_any && entry.endpoint != endpoint) {
+                continue;
+            }
+            if (entry.is_leased) {
+                is_waitable = true;
+                continue;
+            }
+            if (is_tried[index]) {
+                continue;
+            }
+            if (entry.is_healthy) {
+                found = index;
+                break;
+            }
+            if (fallback == count) {
+                fallback = index;
+            }
+        }
+        if (found == count) {
+            found = fallback;
+        }
+
+        if (found == count) {
+            /* 貸し出し中の接続が返るのを待つ。待つ接続もなければ諦める */
+            if (!is_waitable || condition.wait_until(lock, deadline) == std::cv_status::timeout) {
+                return false;
+            }
+            continue;
+        }
+
+        GsPoolEntry& entry = entries[found];
+        entry.is_leased = true;
+        is_tried[found] = true;
+        next_index = (found + 1) % count;
+        gsapi_session* session = entry.session.get();
+        const size_t entry_endpoint = entry.endpoint;
+        if (is_stale(entry, std::chrono::steady_clock::now())) {
+            /* しばらく使われていない接続は、貸し出す前に使えることを確かめる */
+            lock.unlock();
+            const bool is_healthy = session->is_connect();
+            lock.lock();
+            entry.is_healthy = is_healthy;
+            entry.last_checked = std::chrono::steady_clock::now();
+            if (!is_healthy) {
+                entry.is_leased = false;
+                condition.notify_all();
+                continue;
+            }
+        }
+        lease = gsapi_lease(this, found, session, entry_endpoint);
+        return true;
+    }
+}
+
+void gsapi_pool::give_back(const size_t index, const bool is_healthy)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index >= entries.size()) {
+        return;
+    }
+    GsPoolEntry& entry = entries[index];
+    entry.is_leased = false;
+    if (is_healthy) {
+        entry.last_checked = std::chrono::steady_clock::now();
+    } else {
+        entry.is_healthy = false;
+    }
+    condition.notify_all();
+}
+
+bool gsapi_pool::is_stale(const GsPoolEntry& entry, const std::chrono::steady_clock::time_point& now) const
+{
+    return !entry.is_healthy || (now - entry.last_checked >= std::chrono::milliseconds(config.idle_check_msec));
+}
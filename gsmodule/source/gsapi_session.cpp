@@ -0,0 +1,1086 @@
+﻿/****************************************************************
+ * @file    gsapi_session.cpp
+ * @brief   1つのツールとの通信設定と接続を持ち、GameSynth Tool APIを呼び出す
+ * @version 1.0.12
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_session.h"
+#include "../include/gsapi_codec.h"
+#include "../include/gsapi_curve.h"
+#include <utility>
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gsapi_session::gsapi_session()
+    : config()
+    , connection()
+    , pipelining(false)
+    , pipeline_messages()
+    , pipeline_count(0)
+    , pipeline_responses()
+    , send_buffer()
+    , curve_buffer()
+    , mirror()
+{
+}
+
+gsapi_session::gsapi_session(const GsApiClientConfig& config)
+    : config(config)
+    , connection()
+    , pipelining(false)
+    , pipeline_messages()
+    , pipeline_count(0)
+    , pipeline_responses()
+    , send_buffer()
+    , curve_buffer()
+    , mirror()
+{
+}
+
+bool gsapi_session::set_config(const GsApiClientConfig& config)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    this->config = config;
+    /* 接続先が変わるかもしれないので、覚えている情報は使わない */
+    mirror = GsSessionMirror();
+    return true;
+}
+
+bool gsapi_session::get_config(GsApiClientConfig& config)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    config = this->config;
+    return true;
+}
+
+bool gsapi_session::send_command(const std::string& message, std::string& response)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response_view;
+    const bool result = send_command(message, response_view);
+    response = response_view;
+    return result;
+}
+
+bool gsapi_session::send_command(const std::string& message, std::string_view& response)
+{
+    bool is_replied = false;
+    return send_command(message, response, is_replied);
+}
+
+bool gsapi_session::send_command(const std::string& message, std::string_view& response, bool& is_replied)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (pipelining) {
+        /* パイプライン中は送信データに追記し、応答はend_pipelineでまとめて受け取る */
+        pipeline_messages += message;
+        pipeline_count++;
+        response = std::string_view();
+        is_replied = false;
+        return true;
+    }
+    connection.set_endpoint(config.ip_address, config.port_number);
+    connection.set_timeout(config.connect_timeout_msec, config.send_timeout_msec, config.receive_timeout_msec);
+    return connection.send_command(message, config.delimiter, response, is_replied);
+}
+
+bool gsapi_session::send_query(const std::string& message, std::string_view& response)
+{
+    bool is_replied = false;
+    return send_query(message, response, is_replied);
+}
+
+bool gsapi_session::send_query(const std::string& message, std::string_view& response, bool& is_replied)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (pipelining) {
+        /* 応答はend_pipelineで受け取るので、蓄積だけして値は返さない */
+        send_command(message, response, is_replied);
+        return false;
+    }
+    return send_command(message, response, is_replied);
+}
+
+bool gsapi_session::query_names(const bool is_curve, std::vector<std::string>& names, bool& is_replied)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    names.clear();
+    is_replied = false;
+    if (is_curve) {
+        if (!gsapi_codec::encode_get_curvenames(config.delimiter, send_buffer)) {
+            return false;
+        }
+        const bool result = send_query(send_buffer, response, is_replied);
+        gsapi_codec::decode_reply<GS_COMMAND_GET_CURVENAMES>(response, names);
+        return result;
+    }
+    if (!gsapi_codec::encode_get_metanames(config.delimiter, send_buffer)) {
+        return false;
+    }
+    const bool result = send_query(send_buffer, response, is_replied);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_METANAMES>(response, names);
+    return result;
+}
+
+bool gsapi_session::mirror_names(const bool is_curve)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    bool is_replied = false;
+    std::vector<std::string>& names = is_curve ? mirror.curve_names : mirror.meta_names;
+    const bool result = query_names(is_curve, names, is_replied);
+    /* 期限までに応答がなく空になった一覧は覚えない */
+    (is_curve ? mirror.has_curve_names : mirror.has_meta_names) = result && is_replied;
+    return result;
+}
+
+void gsapi_session::invalidate_mirror()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    mirror = GsSessionMirror();
+}
+
+bool gsapi_session::is_mirroring() const
+{
+    /* パイプライン中は応答がまだないので、覚えている情報も使わない */
+    return config.mirror_cache && !pipelining;
+}
+
+gsapi_session::GsResolveResult gsapi_session::resolve_name(const bool is_curve, const std::string& name, unsigned int& index)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!config.resolve_names) {
+        return GS_RESOLVE_NAME;
+    }
+    bool& has_indices = is_curve ? mirror.has_curve_indices : mirror.has_meta_indices;
+    std::unordered_map<std::string, unsigned int>& indices = is_curve ? mirror.curve_indices : mirror.meta_indices;
+    if (!has_indices) {
+        /* パイプライン中は一覧を受け取れないので、名前のまま送る */
+        if (pipelining) {
+            return GS_RESOLVE_NAME;
+        }
+        std::vector<std::string> names;
+        bool is_replied = false;
+        const bool result = query_names(is_curve, names, is_replied);
+        /* 期限までに応答がない、または一覧が空なら表を作らず、名前のまま送る */
+        if (!result || !is_replied || names.empty()) {
+            return GS_RESOLVE_NAME;
+        }
+        indices.clear();
+        indices.reserve(names.size());
+        for (size_t i = 0; i < names.size(); i++) {
+            /* 同じ名前があれば、先に見つかった方を使う */
+            indices.try_emplace(std::move(names[i]), static_cast<unsigned int>(i));
+        }
+        has_indices = true;
+    }
+    const auto it = indices.find(name);
+    if (it == indices.end()) {
+        return GS_RESOLVE_UNKNOWN;
+    }
+    index = it->second;
+    return GS_RESOLVE_INDEX;
+}
+
+bool gsapi_session::begin_pipeline()
+{
+    /* end_pipelineまで排他を保持し、他のスレッドのコマンドが混ざらないようにする */
+    mutex.lock();
+    if (pipelining) {
+        mutex.unlock();
+        return false;
+    }
+    pipelining = true;
+    pipeline_messages.clear();
+    pipeline_count = 0;
+    return true;
+}
+
+bool gsapi_session::end_pipeline()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    /* 応答を使わないので、配列の容量を使い回す */
+    return end_pipeline(pipeline_responses);
+}
+
+bool gsapi_session::end_pipeline(std::vector<std::string>& responses)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<std::string_view> response_views;
+    const bool result = end_pipeline(response_views);
+    responses.assign(response_views.begin(), response_views.end());
+    return result;
+}
+
+bool gsapi_session::end_pipeline(std::vector<std::string_view>& responses)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    responses.clear();
+    if (!pipelining) {
+        return false;
+    }
+    pipelining = false;
+    /* begin_pipelineで保持した排他を解放する(このスコープの排他は残る) */
+    mutex.unlock();
+    if (pipeline_count == 0) {
+        return true;
+    }
+    connection.set_endpoint(config.ip_address, config.port_number);
+    connection.set_timeout(config.connect_timeout_msec, config.send_timeout_msec, config.receive_timeout_msec);
+    return connection.send_pipeline(pipeline_messages, pipeline_count, config.delimiter, responses);
+}
+
+bool gsapi_session::is_connect()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    /* 無効なコマンドでもメッセージが送信できれば良い */
+    std::string_view response;
+    send_buffer.assign(config.delimiter);
+    return send_command(send_buffer, response);
+}
+
+bool gsapi_session::command_get_version(std::string& version)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_version(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_VERSION>(response, version);
+    return result;
+}
+
+bool gsapi_session::command_get_commands(std::vector<std::string>& commmand_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_commands(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_COMMANDS>(response, commmand_list);
+    return result;
+}
+
+bool gsapi_session::command_get_commands(std::vector<std::string_view>& commmand_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_commands(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_COMMANDS>(response, commmand_list);
+    return result;
+}
+
+bool gsapi_session::command_get_models(std::vector<std::string>& model_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_models(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_MODELS>(response, model_list);
+    return result;
+}
+
+bool gsapi_session::command_get_models(std::vector<std::string_view>& model_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_models(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_MODELS>(response, model_list);
+    return result;
+}
+
+bool gsapi_session::command_select_model(const std::string& model_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    /* 読み込むパッチが変わるので、覚えている情報を捨てる */
+    mirror = GsSessionMirror();
+    if (!gsapi_codec::encode_select_model(model_name, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_get_path(const std::string& path_name, std::string& path_value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_path(path_name, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_PATH>(response, path_value);
+    return result;
+}
+
+bool gsapi_session::command_get_samplerate(std::string& samplerate)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_samplerate(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_SAMPLERATE>(response, samplerate);
+    return result;
+}
+
+bool gsapi_session::command_set_samplerate(const std::string& samplerate)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_set_samplerate(samplerate, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_query_patchnames(const std::string& text, const bool name,
+    const bool category, const bool tags, std::vector<std::string>& patch_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_patchnames(text, name, category, tags, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_PATCHNAMES>(response, patch_list);
+    return result;
+}
+
+bool gsapi_session::command_query_patchnames(const std::string& text, const bool name,
+    const bool category, const bool tags, std::vector<std::string_view>& patch_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_patchnames(text, name, category, tags, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_PATCHNAMES>(response, patch_list);
+    return result;
+}
+
+bool gsapi_session::command_query_patch(const std::string& patch_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    /* 読み込むパッチが変わるので、覚えている情報を捨てる */
+    mirror = GsSessionMirror();
+    if (!gsapi_codec::encode_query_patch(patch_name, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_query_categories(std::vector<std::string>& categoryt_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_categories(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_CATEGORIES>(response, categoryt_list);
+    return result;
+}
+
+bool gsapi_session::command_query_categories(std::vector<std::string_view>& categoryt_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_categories(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_CATEGORIES>(response, categoryt_list);
+    return result;
+}
+
+bool gsapi_session::command_query_tags(std::vector<std::string>& tag_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_tags(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_TAGS>(response, tag_list);
+    return result;
+}
+
+bool gsapi_session::command_query_tags(std::vector<std::string_view>& tag_list)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_query_tags(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_QUERY_TAGS>(response, tag_list);
+    return result;
+}
+
+bool gsapi_session::command_load_patch(const std::string& file_path)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    /* 読み込むパッチが変わるので、覚えている情報を捨てる */
+    mirror = GsSessionMirror();
+    if (!gsapi_codec::encode_load_patch(file_path, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_save_patch(const std::string& file_path)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_save_patch(file_path, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_render_patch(const std::string& file_path, const unsigned int depth,
+    const unsigned int channel, const unsigned int duration)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_render_patch(file_path, depth, channel, duration, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_get_modelname(std::string& model_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring() && mirror.has_model_name) {
+        model_name = mirror.model_name;
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_modelname(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool is_replied = false;
+    bool result = send_query(send_buffer, response, is_replied);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_MODELNAME>(response, model_name);
+    if (result && is_replied && is_mirroring()) {
+        mirror.model_name = model_name;
+        mirror.has_model_name = true;
+    }
+    return result;
+}
+
+bool gsapi_session::command_get_patchname(std::string& patch_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring() && mirror.has_patch_name) {
+        patch_name = mirror.patch_name;
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_patchname(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool is_replied = false;
+    bool result = send_query(send_buffer, response, is_replied);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_PATCHNAME>(response, patch_name);
+    if (result && is_replied && is_mirroring()) {
+        mirror.patch_name = patch_name;
+        mirror.has_patch_name = true;
+    }
+    return result;
+}
+
+bool gsapi_session::command_get_variation(float& variation)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_variation(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_VARIATION>(response, variation);
+    return result;
+}
+
+bool gsapi_session::command_set_variation(const float& variation)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_set_variation(variation, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_get_drawing(const unsigned int index, std::vector<GsDrawingData>& drawing_data)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_drawing(index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_DRAWING>(response, drawing_data);
+    return result;
+}
+
+bool gsapi_session::command_get_drawing(const unsigned int index, GsDrawingBuffer& drawing_buffer)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_drawing(index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_DRAWING>(response, drawing_buffer);
+    return result;
+}
+
+bool gsapi_session::command_set_drawing(const std::vector<GsDrawingData>& drawing_data)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_set_drawing(drawing_data, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_set_drawing(const GsDrawingBuffer& drawing_buffer)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_set_drawing(drawing_buffer, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_get_metacount(unsigned int& meta_count)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring() && mirror.has_meta_count) {
+        meta_count = mirror.meta_count;
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metacount(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_METACOUNT>(response, meta_count);
+    if (result && is_mirroring()) {
+        mirror.meta_count = meta_count;
+        mirror.has_meta_count = true;
+    }
+    return result;
+}
+
+bool gsapi_session::command_get_metanames(std::vector<std::string>& meta_names)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring()) {
+        /* 覚えている一覧を、問い合わせた場合と同じく配列の末尾に追加する。なければ覚えてから追加する */
+        if (!mirror.has_meta_names && !mirror_names(false)) {
+            return false;
+        }
+        meta_names.insert(meta_names.end(), mirror.meta_names.begin(), mirror.meta_names.end());
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metanames(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_METANAMES>(response, meta_names);
+    return result;
+}
+
+bool gsapi_session::command_get_metanames(std::vector<std::string_view>& meta_names)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring()) {
+        /* 覚えている一覧を指す文字列を、問い合わせた場合と同じく配列の末尾に追加する */
+        if (!mirror.has_meta_names && !mirror_names(false)) {
+            return false;
+        }
+        meta_names.insert(meta_names.end(), mirror.meta_names.begin(), mirror.meta_names.end());
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metanames(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_METANAMES>(response, meta_names);
+    return result;
+}
+
+bool gsapi_session::command_get_metaname(const unsigned int& index, std::string& metaname)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metaname(index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_METANAME>(response, metaname);
+    return result;
+}
+
+bool gsapi_session::command_get_metavalue(const unsigned int& index, float& metavalue)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metavalue(index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_METAVALUE>(response, metavalue);
+    return result;
+}
+
+bool gsapi_session::command_get_metavalue(const std::string& name, float& metavalue)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    unsigned int index = 0;
+    switch (resolve_name(false, name, index)) {
+    case GS_RESOLVE_INDEX:
+        return command_get_metavalue(index, metavalue);
+    case GS_RESOLVE_UNKNOWN:
+        return false;
+    default:
+        break;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_metavalue(name, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_METAVALUE>(response, metavalue);
+    return result;
+}
+
+bool gsapi_session::command_set_metavalue(const unsigned int& index, const float& metavalue)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_set_metavalue(index, metavalue, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_set_metavalue(const std::string& name, const float& metavalue)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    unsigned int index = 0;
+    switch (resolve_name(false, name, index)) {
+    case GS_RESOLVE_INDEX:
+        return command_set_metavalue(index, metavalue);
+    case GS_RESOLVE_UNKNOWN:
+        return false;
+    default:
+        break;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_set_metavalue(name, metavalue, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues)
+{
+    std::vector<size_t> failed_indices;
+    return command_set_metavalues(metavalues, failed_indices) && failed_indices.empty();
+}
+
+bool gsapi_session::command_set_metavalues(const std::vector<GsMetaValueEntry>& metavalues, std::vector<size_t>& failed_indices)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    failed_indices.clear();
+    /* パイプライン中であれば、そのパイプラインに追加するだけにする */
+    const bool is_nested = pipelining;
+    if (!is_nested) {
+        /* パイプライン中は名前の一覧を受け取れないので、名前を変換する表は先に作っておく */
+        for (const auto& entry : metavalues) {
+            unsigned int index = 0;
+            if (std::holds_alternative<std::string>(entry.target)) {
+                resolve_name(false, std::get<std::string>(entry.target), index);
+                break;
+            }
+        }
+        if (!begin_pipeline()) {
+            return false;
+        }
+    }
+    /* パイプライン中の送信はメッセージを溜めるだけなので、失敗は送る前に分かったもの(パッチにない名前など)だけ */
+    for (size_t i = 0; i < metavalues.size(); i++) {
+        const GsMetaValueEntry& entry = metavalues[i];
+        bool is_added = false;
+        if (std::holds_alternative<unsigned int>(entry.target)) {
+            is_added = command_set_metavalue(std::get<unsigned int>(entry.target), entry.value);
+        } else {
+            is_added = command_set_metavalue(std::get<std::string>(entry.target), entry.value);
+        }
+        if (!is_added) {
+            failed_indices.push_back(i);
+        }
+    }
+    if (is_nested) {
+        return true;
+    }
+    return end_pipeline();
+}
+
+bool gsapi_session::command_get_curvescount(unsigned int& curves_count)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring() && mirror.has_curves_count) {
+        curves_count = mirror.curves_count;
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvescount(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_CURVESCOUNT>(response, curves_count);
+    if (result && is_mirroring()) {
+        mirror.curves_count = curves_count;
+        mirror.has_curves_count = true;
+    }
+    return result;
+}
+
+bool gsapi_session::command_get_curvenames(std::vector<std::string>& curve_names)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring()) {
+        /* 覚えている一覧を、問い合わせた場合と同じく配列の末尾に追加する。なければ覚えてから追加する */
+        if (!mirror.has_curve_names && !mirror_names(true)) {
+            return false;
+        }
+        curve_names.insert(curve_names.end(), mirror.curve_names.begin(), mirror.curve_names.end());
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvenames(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_CURVENAMES>(response, curve_names);
+    return result;
+}
+
+bool gsapi_session::command_get_curvenames(std::vector<std::string_view>& curve_names)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (is_mirroring()) {
+        /* 覚えている一覧を指す文字列を、問い合わせた場合と同じく配列の末尾に追加する */
+        if (!mirror.has_curve_names && !mirror_names(true)) {
+            return false;
+        }
+        curve_names.insert(curve_names.end(), mirror.curve_names.begin(), mirror.curve_names.end());
+        return true;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvenames(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_CURVENAMES>(response, curve_names);
+    return result;
+}
+
+bool gsapi_session::command_get_curvename(const unsigned int& curve_index, std::string& curve_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvename(curve_index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    gsapi_codec::decode_reply<GS_COMMAND_GET_CURVENAME>(response, curve_name);
+    return result;
+}
+
+bool gsapi_session::command_get_curvevalue(const unsigned int& curve_index, GsCurveValue& curve_value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvevalue(curve_index, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_CURVEVALUE>(response, curve_value);
+    return result;
+}
+
+bool gsapi_session::command_get_curvevalue(const std::string& curve_name, GsCurveValue& curve_value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    unsigned int curve_index = 0;
+    switch (resolve_name(true, curve_name, curve_index)) {
+    case GS_RESOLVE_INDEX:
+        return command_get_curvevalue(curve_index, curve_value);
+    case GS_RESOLVE_UNKNOWN:
+        return false;
+    default:
+        break;
+    }
+    std::string_view response;
+    if (!gsapi_codec::encode_get_curvevalue(curve_name, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_GET_CURVEVALUE>(response, curve_value);
+    return result;
+}
+
+bool gsapi_session::command_set_curvevalue(const unsigned int& curve_index, const GsCurveValue& curve_value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    /* 通信設定で指定されていれば、点を減らしてから送る */
+    const GsCurveValue& send_value = gsapi_curve::prepare(curve_value, config, curve_buffer);
+    if (!gsapi_codec::encode_set_curvevalue(curve_index, send_value, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_set_curvevalue(const std::string& curve_name, const GsCurveValue& curve_value)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    unsigned int curve_index = 0;
+    switch (resolve_name(true, curve_name, curve_index)) {
+    case GS_RESOLVE_INDEX:
+        return command_set_curvevalue(curve_index, curve_value);
+    case GS_RESOLVE_UNKNOWN:
+        return false;
+    default:
+        break;
+    }
+    std::string_view response;
+    /* 通信設定で指定されていれば、点を減らしてから送る */
+    const GsCurveValue& send_value = gsapi_curve::prepare(curve_value, config, curve_buffer);
+    if (!gsapi_codec::encode_set_curvevalue(curve_name, send_value, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values)
+{
+    std::vector<size_t> failed_indices;
+    return command_set_curvevalues(curve_values, failed_indices) && failed_indices.empty();
+}
+
+bool gsapi_session::command_set_curvevalues(const std::vector<GsCurveValueEntry>& curve_values, std::vector<size_t>& failed_indices)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    failed_indices.clear();
+    /* パイプライン中であれば、そのパイプラインに追加するだけにする */
+    const bool is_nested = pipelining;
+    if (!is_nested) {
+        /* パイプライン中は名前の一覧を受け取れないので、名前を変換する表は先に作っておく */
+        for (const auto& entry : curve_values) {
+            unsigned int index = 0;
+            if (std::holds_alternative<std::string>(entry.target)) {
+                resolve_name(true, std::get<std::string>(entry.target), index);
+                break;
+            }
+        }
+        if (!begin_pipeline()) {
+            return false;
+        }
+    }
+    /* パイプライン中の送信はメッセージを溜めるだけなので、失敗は送る前に分かったもの(パッチにない名前など)だけ */
+    for (size_t i = 0; i < curve_values.size(); i++) {
+        const GsCurveValueEntry& entry = curve_values[i];
+        bool is_added = false;
+        if (std::holds_alternative<unsigned int>(entry.target)) {
+            is_added = command_set_curvevalue(std::get<unsigned int>(entry.target), entry.value);
+        } else {
+            is_added = command_set_curvevalue(std::get<std::string>(entry.target), entry.value);
+        }
+        if (!is_added) {
+            failed_indices.push_back(i);
+        }
+    }
+    if (is_nested) {
+        return true;
+    }
+    return end_pipeline();
+}
+
+bool gsapi_session::command_play()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_play(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_stop()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_stop(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_is_playing(bool& is_playing)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_is_playing(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_IS_PLAYING>(response, is_playing);
+    return result;
+}
+
+bool gsapi_session::command_is_infinite(bool& is_infinite)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_is_infinite(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_IS_INFINITE>(response, is_infinite);
+    return result;
+}
+
+bool gsapi_session::command_is_randomized(bool& is_randomized)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_is_randomized(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_query(send_buffer, response);
+    result = result && gsapi_codec::decode_reply<GS_COMMAND_IS_RANDOMIZED>(response, is_randomized);
+    return result;
+}
+
+bool gsapi_session::command_enable_events(const bool is_notification)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_enable_events(is_notification, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_back()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_back(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_front()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_front(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_message(const std::string& message, const GsWindowButton& button)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_message(message, button, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_parameters(const std::vector<GsParameter>& params)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_parameters(params, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_rendering(const bool& show_duration, const bool& show_variations)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_rendering(show_duration, show_variations, config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
+
+bool gsapi_session::command_window_test()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string_view response;
+    if (!gsapi_codec::encode_window_test(config.delimiter, send_buffer)) {
+        return false;
+    }
+    bool result = send_command(send_buffer, response);
+    return result;
+}
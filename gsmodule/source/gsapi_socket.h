@@ -0,0 +1,179 @@
+﻿/****************************************************************
+ * @file    gsapi_socket.h
+ * @brief   ソケット操作のプラットフォーム差を吸収する(gsmodule内部用)
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+#ifndef GSAPI_SOCKET_H
+#define GSAPI_SOCKET_H
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gsapi_connection.h"
+#if (_WIN32)
+    #include <WinSock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+/* プラットフォームごとのソケット操作 */
+#if (_WIN32)
+    #define GS_INVALID_SOCKET           ((GsSocket)INVALID_SOCKET)
+    #define GS_CLOSE_SOCKET(s)          closesocket((SOCKET)(s))
+    #define GS_POLL                     WSAPoll
+    #define GS_SEND_FLAGS               (0)
+#else
+    #define GS_INVALID_SOCKET           (-1)
+    #define GS_CLOSE_SOCKET(s)          close(s)
+    #define GS_POLL                     poll
+    #if defined(MSG_NOSIGNAL)
+        #define GS_SEND_FLAGS           MSG_NOSIGNAL
+    #else
+        #define GS_SEND_FLAGS           (0)
+    #endif
+#endif
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+inline bool set_blocking(const GsSocket sock, const bool is_blocking)
+{
+#if (_WIN32)
+    u_long mode = is_blocking ? 0 : 1;
+    return ioctlsocket((SOCKET)sock, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(sock, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    return fcntl(sock, F_SETFL, is_blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) == 0;
+#endif
+}
+
+inline bool is_interrupted()
+{
+#if (_WIN32)
+    return WSAGetLastError() == WSAEINTR;
+#else
+    return errno == EINTR;
+#endif
+}
+
+inline bool is_would_block()
+{
+#if (_WIN32)
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+#endif
+}
+
+inline short wait_ready(const GsSocket sock, const short events, const std::chrono::steady_clock::time_point& deadline)
+{
+    /* 期限までソケットの準備完了を待ち、発生したイベントを返す。期限切れなら0を返す */
+    while (1) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining < 0) {
+            return 0;
+        }
+        pollfd pfd = {};
+        pfd.fd = sock;
+        pfd.events = events;
+        const int result = GS_POLL(&pfd, 1, static_cast<int>(remaining));
+        if (result > 0) {
+            return pfd.revents;
+        }
+        if (result == 0) {
+            return 0;
+        }
+        if (!is_interrupted()) {
+            return 0;
+        }
+    }
+}
+
+/**************************************************************************
+ * @brief   接続先にTCPで接続する。ソケットはノンブロッキングのまま返す。
+ * @param   ip_address : 接続先のIPアドレス
+ * @param   port_number : 接続先のポート番号
+ * @param   connect_timeout_msec : 接続が完了するまでの期限 [ミリ秒]
+ * @return  接続したソケットを返す。失敗した場合はGS_INVALID_SOCKETを返す。
+ **************************************************************************/
+inline GsSocket open_socket(const std::string& ip_address, const unsigned int port_number, const unsigned int connect_timeout_msec)
+{
+    if (!gsapi_connection::startup()) {
+        return GS_INVALID_SOCKET;
+    }
+
+    /* ソケット作成 */
+    GsSocket new_sock = (GsSocket)socket(AF_INET, SOCK_STREAM, 0);
+    if (new_sock == GS_INVALID_SOCKET) {
+        perror("[gsmodule]failed to create socket.\n");
+        return GS_INVALID_SOCKET;
+    }
+
+    /* 接続先のアドレス設定 */
+    sockaddr_in server = {};
+    server.sin_family = AF_INET;
+    server.sin_port = htons(static_cast<unsigned short>(port_number));
+    if (inet_pton(AF_INET, ip_address.c_str(), &server.sin_addr) != 1) {
+        perror("[gsmodule]failed to convert ip address.\n");
+        GS_CLOSE_SOCKET(new_sock);
+        return GS_INVALID_SOCKET;
+    }
+
+    /* 接続(ソケットは以降もノンブロッキングで使い、待機はpollで行う) */
+    set_blocking(new_sock, false);
+    const int result = connect(new_sock, (sockaddr*)&server, sizeof(server));
+    if (result < 0) {
+#if (_WIN32)
+        const bool is_pending = (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+        const bool is_pending = (errno == EINPROGRESS);
+#endif
+        if (!is_pending) {
+            perror("[gsmodule]failed to connect server.\n");
+            GS_CLOSE_SOCKET(new_sock);
+            return GS_INVALID_SOCKET;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connect_timeout_msec);
+        const bool is_ready = (wait_ready(new_sock, POLLOUT, deadline) != 0);
+        int so_error = 0;
+        socklen_t so_error_len = sizeof(so_error);
+        getsockopt(new_sock, SOL_SOCKET, SO_ERROR, (char*)&so_error, &so_error_len);
+        if (!is_ready || so_error != 0) {
+            perror("[gsmodule]failed to connect server.\n");
+            GS_CLOSE_SOCKET(new_sock);
+            return GS_INVALID_SOCKET;
+        }
+    }
+
+    /* 小さなコマンドを遅延なく送る */
+    const int no_delay = 1;
+    setsockopt(new_sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&no_delay, sizeof(no_delay));
+#if defined(SO_NOSIGPIPE)
+    const int no_sigpipe = 1;
+    setsockopt(new_sock, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+    return new_sock;
+}
+
+#endif /* GSAPI_SOCKET_H */
@@ -0,0 +1,354 @@
+﻿/****************************************************************
+ * @file    gspatch_catalog.cpp
+ * @brief   読み込んだgspatchファイルの一覧をファイルに保存し、変わったファイルだけを読み直す
+ * @version 1.0.2
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gspatch_catalog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <system_error>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+#define GSPATCH_CATALOG_BYTE_ORDER  (0x01020304u)                               /* バイト順の確認値 */
+#define GSPATCH_CATALOG_FIELD_COUNT (7)                                         /* レコードの文字列の数 */
+#define GSPATCH_CATALOG_PARSED      (0x00000001u)                               /* レコードのフラグ : 読めた */
+#define GSPATCH_CATALOG_TEMP_SUFFIX ".tmp"                                      /* 保存中の一時ファイルの接尾辞 */
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* 一覧ファイルのヘッダー */
+typedef struct GsCatalogHeaderStruct {
+    char        magic[8];                                                       /* GSPATCH_CATALOG_MAGIC */
+    uint32_t    byte_order;                                                     /* GSPATCH_CATALOG_BYTE_ORDER */
+    uint32_t    version;                                                        /* GSPATCH_CATALOG_VERSION */
+    uint32_t    count;                                                          /* レコード数 */
+    uint32_t    reserved;                                                       /* 予約(0) */
+    uint64_t    strings_size;                                                   /* 文字列領域の大きさ [バイト] */
+} GsCatalogHeader;
+
+/* 一覧ファイルのレコード */
+typedef struct GsCatalogRecordStruct {
+    uint64_t    file_size;                                                      /* 読んだときの大きさ [バイト] */
+    int64_t     modified_time;                                                  /* 読んだときの更新時刻(UNIX時刻からのナノ秒) */
+    uint32_t    flags;                                                          /* GSPATCH_CATALOG_PARSED */
+    uint32_t    offsets[GSPATCH_CATALOG_FIELD_COUNT];                           /* 文字列領域での位置 */
+    uint32_t    lengths[GSPATCH_CATALOG_FIELD_COUNT];                           /* 文字列の長さ */
+    uint32_t    reserved;                                                       /* 予約(0) */
+} GsCatalogRecord;
+
+static_assert(sizeof(GsCatalogHeader) == 32, "unexpected catalog header size");
+static_assert(sizeof(GsCatalogRecord) == 80, "unexpected catalog record size");
+
+/* レコードの文字列の並び */
+static std::string_view GameSynthPatchView::* const catalog_fields[GSPATCH_CATALOG_FIELD_COUNT] = {
+    &GameSynthPatchView::filepath,
+    &GameSynthPatchView::tool_version,
+    &GameSynthPatchView::patch_name,
+    &GameSynthPatchView::patch_version,
+    &GameSynthPatchView::author,
+    &GameSynthPatchView::ucs_category,
+    &GameSynthPatchView::ucs_sub_catebory,
+};
+
+/* 読み直した値の文字列の並び(catalog_fieldsと同じ順) */
+static std::string GameSynthPatchData::* const parsed_fields[GSPATCH_CATALOG_FIELD_COUNT] = {
+    &GameSynthPatchData::filepath,
+    &GameSynthPatchData::tool_version,
+    &GameSynthPatchData::patch_name,
+    &GameSynthPatchData::patch_version,
+    &GameSynthPatchData::author,
+    &GameSynthPatchData::ucs_category,
+    &GameSynthPatchData::ucs_sub_catebory,
+};
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static bool is_path_less(const GsCatalogEntry& entry, const std::string& file_path);
+static GsCatalogEntry* find_entry(std::vector<GsCatalogEntry>& entries, const std::string& file_path);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static bool is_path_less(const GsCatalogEntry& entry, const std::string& file_path)
+{
+    return entry.data.filepath < file_path;
+}
+
+static GsCatalogEntry* find_entry(std::vector<GsCatalogEntry>& entries, const std::string& file_path)
+{
+    const auto it = std::lower_bound(entries.begin(), entries.end(), file_path, is_path_less);
+    if ((it == entries.end()) || (it->data.filepath != file_path)) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gspatch_catalog::gspatch_catalog()
+    : entries()
+    , file()
+    , file_path()
+    , arena(std::make_unique<gspatch_arena>())
+    , parsed_count(0)
+{
+}
+
+bool gspatch_catalog::load(const std::string& catalog_path)
+{
+    entries.clear();
+    arena->clear();
+    file_path.clear();
+    parsed_count = 0;
+    if (!file.open(catalog_path)) {
+        return false;
+    }
+    /* 読めなかった場合に一覧ファイルを割り当てたままにしない */
+    if (!load_records()) {
+        entries.clear();
+        file.close();
+        return false;
+    }
+    file_path = catalog_path;
+    return true;
+}
+
+bool gspatch_catalog::load_records()
+{
+    const std::string_view image = file.view();
+
+    /* 形式が違えば読まない(呼び出し側はupdateですべて読み直す) */
+    GsCatalogHeader header = {};
+    if (image.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, image.data(), sizeof(header));
+    if ((std::memcmp(header.magic, GSPATCH_CATALOG_MAGIC, sizeof(header.magic)) != 0)
+        || (header.byte_order != GSPATCH_CATALOG_BYTE_ORDER)
+        || (header.version != GSPATCH_CATALOG_VERSION)) {
+        return false;
+    }
+    const uint64_t records_size = static_cast<uint64_t>(header.count) * sizeof(GsCatalogRecord);
+    const uint64_t body_size = image.size() - sizeof(header);
+    if ((records_size > body_size) || (header.strings_size != body_size - records_size)) {
+        /* 書きかけか壊れている */
+        return false;
+    }
+    const char* records = image.data() + sizeof(header);
+    const char* strings = records + records_size;
+
+    /* 文字列は複製せず、割り当てた文字列領域を指す */
+    std::vector<GsCatalogEntry> loaded(header.count);
+    for (size_t i = 0; i < loaded.size(); i++) {
+        /* 割り当てた先頭は境界がそろっているが、読み方は境界に依存させない */
+        GsCatalogRecord record = {};
+        std::memcpy(&record, records + i * sizeof(record), sizeof(record));
+        GsCatalogEntry& entry = loaded[i];
+        for (size_t field = 0; field < GSPATCH_CATALOG_FIELD_COUNT; field++) {
+            const uint64_t offset = record.offsets[field];
+            const uint64_t length = record.lengths[field];
+            if (offset + length > header.strings_size) {
+                return false;
+            }
+            entry.data.*catalog_fields[field] = std::string_view(strings + offset, static_cast<size_t>(length));
+        }
+        entry.file_size = record.file_size;
+        entry.modified_time = record.modified_time;
+        entry.is_parsed = ((record.flags & GSPATCH_CATALOG_PARSED) != 0);
+    }
+    /* saveはファイルパスの順に書くが、手を加えられていても引けるようにそろえ直す */
+    std::sort(loaded.begin(), loaded.end(), [](const GsCatalogEntry& left, const GsCatalogEntry& right) {
+        return left.data.filepath < right.data.filepath;
+    });
+    entries = std::move(loaded);
+    return true;
+}
+
+bool gspatch_catalog::save(const std::string& catalog_path)
+{
+    if (entries.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    /* 文字列領域を先に詰め、レコードには位置と長さだけを書く */
+    std::vector<GsCatalogRecord> records(entries.size());
+    std::string strings;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const GsCatalogEntry& entry = entries[i];
+        GsCatalogRecord& record = records[i];
+        record = GsCatalogRecord();
+        record.file_size = entry.file_size;
+        record.modified_time = entry.modified_time;
+        record.flags = entry.is_parsed ? GSPATCH_CATALOG_PARSED : 0u;
+        for (size_t field = 0; field < GSPATCH_CATALOG_FIELD_COUNT; field++) {
+            const std::string_view value = entry.data.*catalog_fields[field];
+            if (strings.size() + value.size() > std::numeric_limits<uint32_t>::max()) {
+                perror("[gsmodule]catalog is too large.\n");
+                return false;
+            }
+            record.offsets[field] = static_cast<uint32_t>(strings.size());
+            record.lengths[field] = static_cast<uint32_t>(value.size());
+            strings.append(value);
+        }
+    }
+    GsCatalogHeader header = {};
+    std::memcpy(header.magic, GSPATCH_CATALOG_MAGIC, sizeof(header.magic));
+    header.byte_order = GSPATCH_CATALOG_BYTE_ORDER;
+    header.version = GSPATCH_CATALOG_VERSION;
+    header.count = static_cast<uint32_t>(records.size());
+    header.strings_size = strings.size();
+
+    /* 途中で失敗しても前の一覧ファイルが残るように、一時ファイルに書いてから置き換える */
+    const std::string temp_path = catalog_path + GSPATCH_CATALOG_TEMP_SUFFIX;
+    FILE* file = std::fopen(temp_path.c_str(), "wb");
+    if (file == nullptr) {
+        perror("[gsmodule]failed to open catalog.\n");
+        return false;
+    }
+    bool result = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+    if (result && !records.empty()) {
+        result = (std::fwrite(records.data(), sizeof(GsCatalogRecord), records.size(), file) == records.size());
+    }
+    if (result && !strings.empty()) {
+        result = (std::fwrite(strings.data(), 1, strings.size(), file) == strings.size());
+    }
+    result = (std::fclose(file) == 0) && result;
+#if (_WIN32)
+    if (result && !this->file.view().empty() && (catalog_path == file_path)) {
+        /* 割り当て中のファイルは置き換えられないので、文字列をアリーナに移してから解除する */
+        for (auto& entry : entries) {
+            if (is_mapped(entry.data)) {
+                store_entry(entry.data, *arena);
+            }
+        }
+        this->file.close();
+        file_path.clear();
+    }
+#endif
+    std::error_code error;
+    if (result) {
+        std::filesystem::rename(temp_path, catalog_path, error);
+        result = !error;
+    }
+    if (!result) {
+        perror("[gsmodule]failed to write catalog.\n");
+        std::filesystem::remove(temp_path, error);
+    }
+    return result;
+}
+
+bool gspatch_catalog::update(const std::string& root_path, const GsPatchScanConfig& config)
+{
+    parsed_count = 0;
+    std::vector<GsPatchFile> files;
+    if (!gspatch_scanner::find_files(root_path, config.is_recursive, files)) {
+        return false;
+    }
+    std::sort(files.begin(), files.end(), [](const GsPatchFile& left, const GsPatchFile& right) {
+        return left.filepath < right.filepath;
+    });
+
+    /*
+     * 大きさと更新時刻が変わっていなければ前の結果を使い、それ以外を読み直す。
+     * 前にアリーナに置いた値は、使い続けるものだけを新しいアリーナに移して古いアリーナを捨てる。
+     */
+    std::unique_ptr<gspatch_arena> next_arena = std::make_unique<gspatch_arena>();
+    std::vector<GsCatalogEntry> updated(files.size());
+    std::vector<std::string> changed_paths;
+    size_t previous = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        GsPatchFile& patch_file = files[i];
+        GsCatalogEntry& entry = updated[i];
+        /* どちらもファイルパスの順なので、前の一覧は先頭から1回だけたどる */
+        while ((previous < entries.size()) && (entries[previous].data.filepath < patch_file.filepath)) {
+            previous++;
+        }
+        if ((previous < entries.size())
+            && (entries[previous].data.filepath == patch_file.filepath)
+            && (entries[previous].file_size == patch_file.file_size)
+            && (entries[previous].modified_time == patch_file.modified_time)) {
+            entry = entries[previous];
+            if (!is_mapped(entry.data)) {
+                store_entry(entry.data, *next_arena);
+            }
+            previous++;
+            continue;
+        }
+        entry.data.filepath = next_arena->store(patch_file.filepath);
+        entry.file_size = patch_file.file_size;
+        entry.modified_time = patch_file.modified_time;
+        changed_paths.push_back(std::move(patch_file.filepath));
+    }
+    entries = std::move(updated);
+    arena = std::move(next_arena);
+    if (changed_paths.empty()) {
+        return true;
+    }
+
+    std::mutex mutex;
+    gspatch_scanner::scan_files(changed_paths, config,
+        [this, &mutex](bool is_parsed, const GameSynthPatchData& gspatch_data) {
+            std::lock_guard<std::mutex> lock(mutex);
+            GsCatalogEntry* entry = find_entry(entries, gspatch_data.filepath);
+            if (entry == nullptr) {
+                return;
+            }
+            /* ファイルパスは置いてあるので、残りの値だけをアリーナに置く */
+            for (size_t field = 1; field < GSPATCH_CATALOG_FIELD_COUNT; field++) {
+                entry->data.*catalog_fields[field] = arena->store(gspatch_data.*parsed_fields[field]);
+            }
+            entry->is_parsed = is_parsed;
+        });
+    parsed_count = changed_paths.size();
+    return true;
+}
+
+const std::vector<GsCatalogEntry>& gspatch_catalog::get_entries() const
+{
+    return entries;
+}
+
+const GsCatalogEntry* gspatch_catalog::find(const std::string& file_path) const
+{
+    const auto it = std::lower_bound(entries.begin(), entries.end(), file_path, is_path_less);
+    if ((it == entries.end()) || (it->data.filepath != file_path)) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+size_t gspatch_catalog::get_parsed_count() const
+{
+    return parsed_count;
+}
+
+bool gspatch_catalog::is_mapped(const GameSynthPatchView& view) const
+{
+    /* 1つのレコードの文字列は、すべて一覧ファイルかすべてアリーナにある */
+    const std::string_view image = file.view();
+    const char* text = view.filepath.data();
+    return !image.empty() && (text != nullptr) && (std::less_equal<const char*>()(image.data(), text))
+        && (std::less<const char*>()(text, image.data() + image.size()));
+}
+
+void gspatch_catalog::store_entry(GameSynthPatchView& view, gspatch_arena& to_arena) const
+{
+    for (size_t field = 0; field < GSPATCH_CATALOG_FIELD_COUNT; field++) {
+        view.*catalog_fields[field] = to_arena.store(view.*catalog_fields[field]);
+    }
+}
@@ -0,0 +1,187 @@
+﻿/****************************************************************
+ * @file    gspatch_file.cpp
+ * @brief   gspatchファイルをメモリに割り当てて読む
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gspatch_file.h"
+#if (_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+    #include <filesystem>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gspatch_file::gspatch_file()
+    : data(nullptr)
+    , size(0)
+#if (_WIN32)
+    , file_handle(INVALID_HANDLE_VALUE)
+    , mapping_handle(nullptr)
+#else
+    , file_descriptor(-1)
+#endif
+{
+}
+
+gspatch_file::~gspatch_file()
+{
+    close();
+}
+
+bool gspatch_file::open(const std::string& file_path)
+{
+    close();
+#if (_WIN32)
+    const std::wstring wide_path = std::filesystem::u8path(file_path).wstring();
+    file_handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(file_size.QuadPart);
+    if (size == 0) {
+        /* 空のファイルは割り当てられない */
+        return true;
+    }
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        close();
+        return false;
+    }
+    data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        perror("[gsmodule]failed to map file.\n");
+        close();
+        return false;
+    }
+#else
+    file_descriptor = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) {
+        return false;
+    }
+    struct stat file_status = {};
+    if (fstat(file_descriptor, &file_status) != 0) {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(file_status.st_size);
+    if (size == 0) {
+        /* 空のファイルは割り当てられない */
+        return true;
+    }
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if (address == MAP_FAILED) {
+        perror("[gsmodule]failed to map file.\n");
+        close();
+        return false;
+    }
+    /* 先頭から順に読むので、先読みを促す */
+    madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(address);
+#endif
+    return true;
+}
+
+void gspatch_file::close()
+{
+#if (_WIN32)
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+    }
+    if (file_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle);
+        file_handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+        file_descriptor = -1;
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+std::string_view gspatch_file::view() const
+{
+    if (data == nullptr) {
+        return std::string_view();
+    }
+    return std::string_view(data, size);
+}
+
+gspatch_arena::gspatch_arena(const size_t block_size)
+    : blocks()
+    , block_size(std::max<size_t>(block_size, 1))
+    , current(nullptr)
+    , available(0)
+    , stored_size(0)
+{
+}
+
+std::string_view gspatch_arena::store(std::string_view text)
+{
+    if (text.empty()) {
+        return std::string_view();
+    }
+    if (text.size() > available) {
+        if (text.size() > block_size) {
+            /* 大きな文字列は専用に確保し、詰めている領域はそのまま使い続ける */
+            blocks.push_back(std::make_unique<char[]>(text.size()));
+            std::memcpy(blocks.back().get(), text.data(), text.size());
+            stored_size += text.size();
+            return std::string_view(blocks.back().get(), text.size());
+        }
+        blocks.push_back(std::make_unique<char[]>(block_size));
+        current = blocks.back().get();
+        available = block_size;
+    }
+    char* destination = current;
+    std::memcpy(destination, text.data(), text.size());
+    current += text.size();
+    available -= text.size();
+    stored_size += text.size();
+    return std::string_view(destination, text.size());
+}
+
+void gspatch_arena::clear()
+{
+    blocks.clear();
+    current = nullptr;
+    available = 0;
+    stored_size = 0;
+}
+
+size_t gspatch_arena::size() const
+{
+    return stored_size;
+}
@@ -1,7 +1,7 @@
 ﻿/****************************************************************
  * @file    gspatch_parser.h
  * @brief   gspatchを解釈する
- * @version 1.0.0
+ * @version 1.0.3
  * @auther  ysd
  ****************************************************************/
 
@@ -10,7 +10,151 @@
  ****************************************************************/
 #include "../include/gspatch_parser.h"
 #include "../include/gspatch_element.h"
+#include "../include/gspatch_file.h"
+#include "../include/gspatch_reader.h"
 #include <tinyxml2.h>
+#include <utility>
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static bool read_header(tinyxml2::XMLDocument& doc, GameSynthPatchData& gspatch_data);
+static const tinyxml2::XMLElement* find_section(const tinyxml2::XMLDocument& doc, const GsPatchSectionId id);
+static void decode_record(const tinyxml2::XMLElement& element, GsPatchRecord& record);
+static void copy_attribute(const tinyxml2::XMLElement* element, const char* name, std::string& value);
+template <typename Field, typename Store>
+static void copy_attribute(const GsPatchToken& token, const char* name, Field& value, const Store& store);
+template <typename Header, typename Store>
+static bool scan_header(std::string_view text_data, Header& header, const Store& store);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static void copy_attribute(const tinyxml2::XMLElement* element, const char* name, std::string& value)
+{
+    /* 要素や属性がなければ空のままにする */
+    if (element == nullptr) {
+        return;
+    }
+    const tinyxml2::XMLAttribute* attribute = element->FindAttribute(name);
+    if (attribute != nullptr) {
+        value = attribute->Value();
+    }
+}
+
+template <typename Field, typename Store>
+static void copy_attribute(const GsPatchToken& token, const char* name, Field& value, const Store& store)
+{
+    std::string_view text;
+    if (gspatch_reader::find_attribute(token, name, text)) {
+        store(text, value);
+    }
+}
+
+template <typename Header, typename Store>
+static bool scan_header(std::string_view text_data, Header& header, const Store& store)
+{
+    /*
+     * DOMを作らずに先頭から読む。Patchの子要素はAuthorとUCSの属性だけを読み、
+     * 中身は解釈せずに読み飛ばす。ヘッダーがそろった時点で読むのをやめる。
+     */
+    gspatch_reader reader(text_data);
+    GsPatchToken token;
+    bool is_patch_found = false;
+    bool is_author_found = false;
+    bool is_ucs_found = false;
+    while (!(is_author_found && is_ucs_found) && reader.next(token)) {
+        if (token.type == GSPATCH_TOKEN_END) {
+            if (token.depth <= 2) {
+                /* PatchかGameSynthPatchが終わった */
+                break;
+            }
+            continue;
+        }
+        if (token.type != GSPATCH_TOKEN_START) {
+            continue;
+        }
+        if (token.depth == 1) {
+            if (token.name != GSPATCH_ELEMENT_GAME_SYNTHP_ATCH) {
+                return false;
+            }
+            copy_attribute(token, GSPATCH_ATTRIBUTE_TOOL_VERSION, header.tool_version, store);
+        } else if ((token.depth == 2) && !is_patch_found && (token.name == GSPATCH_ELEMENT_PATCH)) {
+            copy_attribute(token, GSPATCH_ATTRIBUTE_PATCH_NAME, header.patch_name, store);
+            copy_attribute(token, GSPATCH_ATTRIBUTE_PATCH_VERSION, header.patch_version, store);
+            is_patch_found = true;
+        } else {
+            /* Patch以外の要素は読み飛ばすので、深さ3の要素はPatchの子要素 */
+            if ((token.depth == 3) && (token.name == GSPATCH_ELEMENT_AUTHOR)) {
+                copy_attribute(token, GSPATCH_ATTRIBUTE_VALUE, header.author, store);
+                is_author_found = true;
+            } else if ((token.depth == 3) && (token.name == GSPATCH_ELEMENT_UCS)) {
+                copy_attribute(token, GSPATCH_ATTRIBUTE_UCS_CATEGORY, header.ucs_category, store);
+                copy_attribute(token, GSPATCH_ATTRIBUTE_UCS_SUB_CATEGORY, header.ucs_sub_catebory, store);
+                is_ucs_found = true;
+            }
+            reader.skip_element();
+        }
+    }
+    return is_patch_found && !reader.is_error();
+}
+
+static bool read_header(tinyxml2::XMLDocument& doc, GameSynthPatchData& gspatch_data)
+{
+    tinyxml2::XMLElement* element_game_synth_patch = doc.FirstChildElement(GSPATCH_ELEMENT_GAME_SYNTHP_ATCH);
+    if (element_game_synth_patch == nullptr) {
+        return false;
+    }
+    copy_attribute(element_game_synth_patch, GSPATCH_ATTRIBUTE_TOOL_VERSION, gspatch_data.tool_version);
+    tinyxml2::XMLElement* element_patch = element_game_synth_patch->FirstChildElement(GSPATCH_ELEMENT_PATCH);
+    if (element_patch == nullptr) {
+        return false;
+    }
+    copy_attribute(element_patch, GSPATCH_ATTRIBUTE_PATCH_NAME, gspatch_data.patch_name);
+    copy_attribute(element_patch, GSPATCH_ATTRIBUTE_PATCH_VERSION, gspatch_data.patch_version);
+    copy_attribute(element_patch->FirstChildElement(GSPATCH_ELEMENT_AUTHOR), GSPATCH_ATTRIBUTE_VALUE, gspatch_data.author);
+    const tinyxml2::XMLElement* element_ucs = element_patch->FirstChildElement(GSPATCH_ELEMENT_UCS);
+    copy_attribute(element_ucs, GSPATCH_ATTRIBUTE_UCS_CATEGORY, gspatch_data.ucs_category);
+    copy_attribute(element_ucs, GSPATCH_ATTRIBUTE_UCS_SUB_CATEGORY, gspatch_data.ucs_sub_catebory);
+    return true;
+}
+
+static const tinyxml2::XMLElement* find_section(const tinyxml2::XMLDocument& doc, const GsPatchSectionId id)
+{
+    const tinyxml2::XMLElement* element_game_synth_patch = doc.FirstChildElement(GSPATCH_ELEMENT_GAME_SYNTHP_ATCH);
+    if (element_game_synth_patch == nullptr) {
+        return nullptr;
+    }
+    /* セクションはPatchの子要素。見つからなければGameSynthPatchの直下も探す */
+    const char* name = gspatch_parser::section_name(id);
+    const tinyxml2::XMLElement* element_patch = element_game_synth_patch->FirstChildElement(GSPATCH_ELEMENT_PATCH);
+    if (element_patch != nullptr) {
+        const tinyxml2::XMLElement* element = element_patch->FirstChildElement(name);
+        if (element != nullptr) {
+            return element;
+        }
+    }
+    return element_game_synth_patch->FirstChildElement(name);
+}
+
+static void decode_record(const tinyxml2::XMLElement& element, GsPatchRecord& record)
+{
+    record.name = element.Name();
+    record.attributes.clear();
+    for (const tinyxml2::XMLAttribute* attribute = element.FirstAttribute(); attribute != nullptr; attribute = attribute->Next()) {
+        GsPatchAttribute value;
+        value.name = attribute->Name();
+        value.value = attribute->Value();
+        record.attributes.push_back(std::move(value));
+    }
+    const char* text = element.GetText();
+    record.text = (text != nullptr) ? text : "";
+    record.children.clear();
+    for (const tinyxml2::XMLElement* child = element.FirstChildElement(); child != nullptr; child = child->NextSiblingElement()) {
+        record.children.emplace_back();
+        decode_record(*child, record.children.back());
+    }
+}
 
 /****************************************************************
  * クラス定義
@@ -23,22 +167,138 @@ bool gspatch_parser::parse(const std::string &text_data, GameSynthPatchData &gsp
     if (result != tinyxml2::XML_SUCCESS) {
         return false;
     }
-    tinyxml2::XMLElement* element_game_synth_patch = doc.FirstChildElement(GSPATCH_ELEMENT_GAME_SYNTHP_ATCH);
-    {
-        auto tool_version = element_game_synth_patch->FindAttribute(GSPATCH_ATTRIBUTE_TOOL_VERSION);
-        gspatch_data.tool_version = tool_version->Value();
+    return read_header(doc, gspatch_data);
+}
+
+bool gspatch_parser::parse_header(std::string_view text_data, GameSynthPatchData& gspatch_data)
+{
+    return scan_header(text_data, gspatch_data, [](std::string_view text, std::string& value) {
+        gspatch_reader::unescape(text, value);
+    });
+}
+
+bool gspatch_parser::parse_header(std::string_view text_data, GameSynthPatchView& gspatch_view, gspatch_arena& arena)
+{
+    /* 実体参照を含む値だけを戻してアリーナに置き、それ以外はテキストデータを指す */
+    std::string unescaped;
+    return scan_header(text_data, gspatch_view, [&arena, &unescaped](std::string_view text, std::string_view& value) {
+        if (text.find('&') == std::string_view::npos) {
+            value = text;
+            return;
+        }
+        gspatch_reader::unescape(text, unescaped);
+        value = arena.store(unescaped);
+    });
+}
+
+bool gspatch_parser::parse_file(const std::string& file_path, GameSynthPatchData& gspatch_data)
+{
+    gspatch_file file;
+    if (!file.open(file_path)) {
+        return false;
     }
-    tinyxml2::XMLElement* element_patch = element_game_synth_patch->FirstChildElement(GSPATCH_ELEMENT_PATCH);
-    {
-        auto patch_name = element_patch->FindAttribute(GSPATCH_ATTRIBUTE_PATCH_NAME);
-        gspatch_data.patch_name = patch_name->Value();
-        auto patch_version = element_patch->FindAttribute(GSPATCH_ATTRIBUTE_PATCH_VERSION);
-        gspatch_data.patch_version = patch_version->Value();
+    gspatch_data.filepath = file_path;
+    return parse_header(file.view(), gspatch_data);
+}
+
+bool gspatch_parser::parse_file(const std::string& file_path, gspatch_file& file,
+    GameSynthPatchView& gspatch_view, gspatch_arena& arena)
+{
+    if (!file.open(file_path)) {
+        return false;
+    }
+    gspatch_view.filepath = arena.store(file_path);
+    return parse_header(file.view(), gspatch_view, arena);
+}
+
+bool gspatch_parser::parse_file(const std::string& file_path, GameSynthPatchView& gspatch_view, gspatch_arena& arena)
+{
+    /* ファイルはすぐに閉じるので、値はすべてアリーナに置く */
+    gspatch_file file;
+    if (!file.open(file_path)) {
+        return false;
+    }
+    gspatch_view.filepath = arena.store(file_path);
+    std::string unescaped;
+    return scan_header(file.view(), gspatch_view, [&arena, &unescaped](std::string_view text, std::string_view& value) {
+        if (text.find('&') == std::string_view::npos) {
+            value = arena.store(text);
+            return;
+        }
+        gspatch_reader::unescape(text, unescaped);
+        value = arena.store(unescaped);
+    });
+}
+
+const char* gspatch_parser::section_name(const GsPatchSectionId id)
+{
+    switch (id) {
+    case GSPATCH_SECTION_ALGO_PARAMETERS:   return GSPATCH_ELEMENT_ALGO_PARAMETERS;
+    case GSPATCH_SECTION_PARAMETERS:        return GSPATCH_ELEMENT_PARAMETERS;
+    case GSPATCH_SECTION_META_PARAMETERS:   return GSPATCH_ELEMENT_META_PARAMETERS;
+    case GSPATCH_SECTION_EVENTS:            return GSPATCH_ELEMENT_EVENTS;
+    case GSPATCH_SECTION_AUTOMATION_CURVES: return GSPATCH_ELEMENT_AUTOMATION_CURVES;
+    case GSPATCH_SECTION_INPUT_CONTROLS:    return GSPATCH_ELEMENT_INPUT_CONTROLS;
+    case GSPATCH_SECTION_RANDOM_PLAY:       return GSPATCH_ELEMENT_RANDOM_PLAY;
+    default:                                return "";
     }
-    tinyxml2::XMLElement* element_author = element_patch->FirstChildElement(GSPATCH_ELEMENT_AUTHOR);
-    {
-        auto author = element_author->FindAttribute(GSPATCH_ATTRIBUTE_VALUE);
-        gspatch_data.author = author->Value();
+}
+
+bool gspatch_parser::get_attribute(const GsPatchRecord& record, const std::string& name, std::string& value)
+{
+    for (const auto& attribute : record.attributes) {
+        if (attribute.name == name) {
+            value = attribute.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+gspatch_model::gspatch_model()
+    : document()
+    , header()
+    , sections()
+    , is_decoded()
+{
+}
+
+gspatch_model::~gspatch_model() = default;
+
+bool gspatch_model::parse(const std::string& text_data)
+{
+    header = GameSynthPatchData();
+    sections = {};
+    is_decoded.fill(false);
+    document = std::make_unique<tinyxml2::XMLDocument>();
+    if ((document->Parse(text_data.c_str()) != tinyxml2::XML_SUCCESS) || !read_header(*document, header)) {
+        document.reset();
+        return false;
     }
     return true;
 }
+
+const GameSynthPatchData& gspatch_model::get_header() const
+{
+    return header;
+}
+
+const GsPatchSection& gspatch_model::get_section(const GsPatchSectionId id)
+{
+    static const GsPatchSection empty_section;
+    if ((id < 0) || (id >= GSPATCH_SECTION_COUNT)) {
+        return empty_section;
+    }
+    GsPatchSection& section = sections[id];
+    if (is_decoded[id] || !document) {
+        return section;
+    }
+    /* 初めて参照されたセクションだけをXMLから取り出す */
+    const tinyxml2::XMLElement* element = find_section(*document, id);
+    if (element != nullptr) {
+        decode_record(*element, section.record);
+        section.is_found = true;
+    }
+    is_decoded[id] = true;
+    return section;
+}
@@ -0,0 +1,383 @@
+﻿/****************************************************************
+ * @file    gspatch_reader.cpp
+ * @brief   gspatchをDOMを作らずに先頭から順に読む
+ * @version 1.0.0
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gspatch_reader.h"
+#include <charconv>
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static bool is_space(const char c);
+static bool is_blank(std::string_view text);
+static bool starts_with(std::string_view text, const size_t position, std::string_view prefix);
+static size_t find_tag_end(std::string_view text, size_t position);
+static size_t skip_markup(std::string_view text, const size_t position);
+static void append_utf8(const unsigned long code, std::string& value);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static bool is_space(const char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+static bool is_blank(std::string_view text)
+{
+    for (const char c : text) {
+        if (!is_space(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool starts_with(std::string_view text, const size_t position, std::string_view prefix)
+{
+    return text.compare(position, prefix.size(), prefix) == 0;
+}
+
+static size_t find_tag_end(std::string_view text, size_t position)
+{
+    /* 属性の値の中の'>'は無視して、タグを閉じる'>'を探す */
+    char quote = '\0';
+    for (; position < text.size(); position++) {
+        const char c = text[position];
+        if (quote != '\0') {
+            if (c == quote) {
+                quote = '\0';
+            }
+        } else if ((c == '"') || (c == '\'')) {
+            quote = c;
+        } else if (c == '>') {
+            return position;
+        }
+    }
+    return std::string_view::npos;
+}
+
+static size_t skip_markup(std::string_view text, const size_t position)
+{
+    /* 宣言、コメント、CDATA、DOCTYPEであれば、その直後の位置を返す。それ以外はpositionを返す */
+    size_t end = std::string_view::npos;
+    if (starts_with(text, position, "<!--")) {
+        end = text.find("-->", position + 4);
+        return (end == std::string_view::npos) ? end : end + 3;
+    }
+    if (starts_with(text, position, "<![CDATA[")) {
+        end = text.find("]]>", position + 9);
+        return (end == std::string_view::npos) ? end : end + 3;
+    }
+    if (starts_with(text, position, "<?")) {
+        end = text.find("?>", position + 2);
+        return (end == std::string_view::npos) ? end : end + 2;
+    }
+    if (starts_with(text, position, "<!")) {
+        end = text.find('>', position + 2);
+        return (end == std::string_view::npos) ? end : end + 1;
+    }
+    return position;
+}
+
+static void append_utf8(const unsigned long code, std::string& value)
+{
+    if (code < 0x80) {
+        value += static_cast<char>(code);
+    } else if (code < 0x800) {
+        value += static_cast<char>(0xC0 | (code >> 6));
+        value += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        value += static_cast<char>(0xE0 | (code >> 12));
+        value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        value += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        value += static_cast<char>(0xF0 | (code >> 18));
+        value += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        value += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+gspatch_reader::gspatch_reader(std::string_view text_data)
+    : text_data(text_data)
+    , position(0)
+    , open_elements()
+    , is_pending_end(false)
+    , has_error(false)
+{
+}
+
+bool gspatch_reader::next(GsPatchToken& token)
+{
+    if (has_error) {
+        return false;
+    }
+    token.attributes.clear();
+    if (is_pending_end) {
+        /* 空要素(<name .../>)のEND */
+        is_pending_end = false;
+        token.type = GSPATCH_TOKEN_END;
+        token.name = open_elements.back();
+        token.text = std::string_view();
+        token.depth = open_elements.size();
+        open_elements.pop_back();
+        return true;
+    }
+    while (position < text_data.size()) {
+        if (text_data[position] != '<') {
+            size_t end = text_data.find('<', position);
+            if (end == std::string_view::npos) {
+                end = text_data.size();
+            }
+            const std::string_view text = text_data.substr(position, end - position);
+            position = end;
+            if (is_blank(text)) {
+                continue;
+            }
+            if (open_elements.empty()) {
+                /* ルート要素の外に文字がある */
+                return fail();
+            }
+            token.type = GSPATCH_TOKEN_TEXT;
+            token.name = open_elements.back();
+            token.text = text;
+            token.depth = open_elements.size();
+            return true;
+        }
+        const size_t end = skip_markup(text_data, position);
+        if (end == std::string_view::npos) {
+            return fail();
+        }
+        if (end == position) {
+            return read_tag(token);
+        }
+        if (starts_with(text_data, position, "<![CDATA[")) {
+            if (open_elements.empty()) {
+                return fail();
+            }
+            token.type = GSPATCH_TOKEN_TEXT;
+            token.name = open_elements.back();
+            token.text = text_data.substr(position + 9, end - position - 12);
+            token.depth = open_elements.size();
+            position = end;
+            return true;
+        }
+        position = end;
+    }
+    if (!open_elements.empty()) {
+        /* 閉じていない要素がある */
+        return fail();
+    }
+    return false;
+}
+
+bool gspatch_reader::skip_element()
+{
+    if (has_error || open_elements.empty()) {
+        return false;
+    }
+    if (is_pending_end) {
+        is_pending_end = false;
+        open_elements.pop_back();
+        return true;
+    }
+    size_t depth = 1;
+    while (true) {
+        position = text_data.find('<', position);
+        if (position == std::string_view::npos) {
+            return fail();
+        }
+        const size_t end = skip_markup(text_data, position);
+        if (end == std::string_view::npos) {
+            return fail();
+        }
+        if (end != position) {
+            position = end;
+            continue;
+        }
+        const size_t tag_end = find_tag_end(text_data, position + 1);
+        if (tag_end == std::string_view::npos) {
+            return fail();
+        }
+        if (text_data[position + 1] == '/') {
+            depth--;
+        } else if (text_data[tag_end - 1] != '/') {
+            depth++;
+        }
+        position = tag_end + 1;
+        if (depth == 0) {
+            open_elements.pop_back();
+            return true;
+        }
+    }
+}
+
+bool gspatch_reader::is_error() const
+{
+    return has_error;
+}
+
+bool gspatch_reader::find_attribute(const GsPatchToken& token, std::string_view name, std::string_view& value)
+{
+    for (const auto& attribute : token.attributes) {
+        if (attribute.name == name) {
+            value = attribute.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void gspatch_reader::unescape(std::string_view text, std::string& value)
+{
+    value.clear();
+    value.reserve(text.size());
+    size_t position = 0;
+    while (position < text.size()) {
+        const size_t amp = text.find('&', position);
+        if (amp == std::string_view::npos) {
+            value.append(text.substr(position));
+            break;
+        }
+        value.append(text.substr(position, amp - position));
+        const size_t semicolon = text.find(';', amp + 1);
+        if (semicolon == std::string_view::npos) {
+            value.append(text.substr(amp));
+            break;
+        }
+        const std::string_view entity = text.substr(amp + 1, semicolon - amp - 1);
+        position = semicolon + 1;
+        if (entity == "lt") {
+            value += '<';
+        } else if (entity == "gt") {
+            value += '>';
+        } else if (entity == "amp") {
+            value += '&';
+        } else if (entity == "quot") {
+            value += '"';
+        } else if (entity == "apos") {
+            value += '\'';
+        } else if ((entity.size() > 1) && (entity[0] == '#')) {
+            const bool is_hex = (entity[1] == 'x') || (entity[1] == 'X');
+            const std::string_view digits = entity.substr(is_hex ? 2 : 1);
+            unsigned long code = 0;
+            const auto result = std::from_chars(digits.data(), digits.data() + digits.size(), code, is_hex ? 16 : 10);
+            if ((result.ec == std::errc()) && (result.ptr == digits.data() + digits.size()) && (code <= 0x10FFFF)) {
+                append_utf8(code, value);
+            } else {
+                value.append(text.substr(amp, position - amp));
+            }
+        } else {
+            /* 知らない実体参照はそのまま残す */
+            value.append(text.substr(amp, position - amp));
+        }
+    }
+}
+
+bool gspatch_reader::read_tag(GsPatchToken& token)
+{
+    token.text = std::string_view();
+    if (starts_with(text_data, position, "</")) {
+        const size_t end = text_data.find('>', position + 2);
+        if (end == std::string_view::npos) {
+            return fail();
+        }
+        std::string_view name = text_data.substr(position + 2, end - position - 2);
+        while (!name.empty() && is_space(name.back())) {
+            name.remove_suffix(1);
+        }
+        if (open_elements.empty() || (open_elements.back() != name)) {
+            return fail();
+        }
+        position = end + 1;
+        token.type = GSPATCH_TOKEN_END;
+        token.name = name;
+        token.depth = open_elements.size();
+        open_elements.pop_back();
+        return true;
+    }
+
+    const size_t begin = ++position;
+    while ((position < text_data.size()) && !is_space(text_data[position])
+        && (text_data[position] != '/') && (text_data[position] != '>')) {
+        position++;
+    }
+    if (position == begin) {
+        return fail();
+    }
+    const std::string_view name = text_data.substr(begin, position - begin);
+    bool is_empty = false;
+    if (!read_attributes(token, is_empty)) {
+        return fail();
+    }
+    open_elements.push_back(name);
+    token.type = GSPATCH_TOKEN_START;
+    token.name = name;
+    token.depth = open_elements.size();
+    is_pending_end = is_empty;
+    return true;
+}
+
+bool gspatch_reader::read_attributes(GsPatchToken& token, bool& is_empty)
+{
+    while (true) {
+        while ((position < text_data.size()) && is_space(text_data[position])) {
+            position++;
+        }
+        if (position >= text_data.size()) {
+            return false;
+        }
+        if (text_data[position] == '>') {
+            position++;
+            return true;
+        }
+        if (starts_with(text_data, position, "/>")) {
+            position += 2;
+            is_empty = true;
+            return true;
+        }
+        const size_t name_begin = position;
+        while ((position < text_data.size()) && !is_space(text_data[position]) && (text_data[position] != '=')) {
+            position++;
+        }
+        GsPatchAttributeView attribute;
+        attribute.name = text_data.substr(name_begin, position - name_begin);
+        while ((position < text_data.size()) && is_space(text_data[position])) {
+            position++;
+        }
+        if ((position >= text_data.size()) || (text_data[position] != '=') || attribute.name.empty()) {
+            return false;
+        }
+        position++;
+        while ((position < text_data.size()) && is_space(text_data[position])) {
+            position++;
+        }
+        if ((position >= text_data.size()) || ((text_data[position] != '"') && (text_data[position] != '\''))) {
+            return false;
+        }
+        const char quote = text_data[position++];
+        const size_t value_end = text_data.find(quote, position);
+        if (value_end == std::string_view::npos) {
+            return false;
+        }
+        attribute.value = text_data.substr(position, value_end - position);
+        position = value_end + 1;
+        token.attributes.push_back(attribute);
+    }
+}
+
+bool gspatch_reader::fail()
+{
+    has_error = true;
+    return false;
+}
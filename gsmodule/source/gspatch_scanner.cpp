@@ -0,0 +1,290 @@
+﻿/****************************************************************
+ * @file    gspatch_scanner.cpp
+ * @brief   パッチライブラリのgspatchファイルを並列に読む
+ * @version 1.0.3
+ * @auther  ysd
+ ****************************************************************/
+
+/****************************************************************
+ * インクルード
+ ****************************************************************/
+#include "../include/gspatch_scanner.h"
+#include "../include/gspatch_element.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/****************************************************************
+ * プリプロセッサ定義
+ ****************************************************************/
+/* file_time_typeの起点からUNIX時刻(1970-01-01 UTC)の起点までの秒数(C++17で標準ライブラリごとに定める) */
+#if defined(_MSC_VER)
+    #define GS_FILE_CLOCK_TO_UNIX_SEC   (-11644473600LL)                        /* 1601-01-01 UTC */
+#elif defined(__GLIBCXX__)
+    #define GS_FILE_CLOCK_TO_UNIX_SEC   (6437664000LL)                          /* 2174-01-01 UTC */
+#else
+    #define GS_FILE_CLOCK_TO_UNIX_SEC   (0LL)                                   /* libc++はUNIX時刻と同じ */
+#endif
+
+/****************************************************************
+ * 構造体宣言
+ ****************************************************************/
+/* スレッドごとの待ち行列 */
+typedef struct GsScanQueueStruct {
+    std::mutex              mutex;                                              /* pathsの排他 */
+    std::deque<std::string> paths;                                              /* 読むファイルのパス */
+} GsScanQueue;
+
+/* 読み込み中の状態 */
+typedef struct GsScanStateStruct {
+    std::vector<std::unique_ptr<GsScanQueue>> queues;                           /* スレッドごとの待ち行列 */
+    std::mutex              mutex;                                              /* 以下の排他 */
+    std::condition_variable condition;                                          /* ファイルの追加と探し終わりの通知 */
+    size_t                  pending = 0;                                        /* 待ち行列にある(入れる途中を含む)ファイルの数 */
+    bool                    is_walking = true;                                  /* 読むファイルを探している途中か */
+} GsScanState;
+
+/****************************************************************
+ * 関数宣言
+ ****************************************************************/
+static bool take_path(GsScanState& state, const size_t index, std::string& path);
+static void run_worker(GsScanState& state, const size_t index, const GsPatchHandler& handler);
+static void push_path(GsScanState& state, size_t& next_queue, std::string file_path);
+static std::string to_utf8(const std::filesystem::path& path);
+static int64_t to_unix_nanoseconds(const std::filesystem::file_time_type& time);
+template <typename Visitor>
+static bool walk(const std::string& root_path, const bool is_recursive, const Visitor& visit);
+template <typename Producer>
+static bool run_scan(const GsPatchScanConfig& config, const GsPatchHandler& handler, const Producer& produce);
+
+/****************************************************************
+ * 関数定義
+ ****************************************************************/
+static bool take_path(GsScanState& state, const size_t index, std::string& path)
+{
+    /* 自分の待ち行列は後ろから、他のスレッドの待ち行列は前から取る */
+    const size_t count = state.queues.size();
+    for (size_t i = 0; i < count; i++) {
+        GsScanQueue& queue = *state.queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.paths.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            path = std::move(queue.paths.back());
+            queue.paths.pop_back();
+        } else {
+            path = std::move(queue.paths.front());
+            queue.paths.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+static void run_worker(GsScanState& state, const size_t index, const GsPatchHandler& handler)
+{
+    std::string path;
+    GameSynthPatchData gspatch_data;
+    while (true) {
+        if (take_path(state, index, path)) {
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.pending--;
+            }
+            gspatch_data = GameSynthPatchData();
+            const bool result = gspatch_parser::parse_file(path, gspatch_data);
+            gspatch_data.filepath = path;
+            handler(result, gspatch_data);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.condition.wait(lock, [&state] { return (state.pending > 0) || !state.is_walking; });
+        if ((state.pending == 0) && !state.is_walking) {
+            break;
+        }
+    }
+}
+
+static std::string to_utf8(const std::filesystem::path& path)
+{
+#if defined(__cpp_char8_t)
+    /* C++20ではu8stringがstd::u8stringを返す */
+    const std::u8string text = path.u8string();
+    return std::string(text.begin(), text.end());
+#else
+    return path.u8string();
+#endif
+}
+
+static int64_t to_unix_nanoseconds(const std::filesystem::file_time_type& time)
+{
+    /* file_time_typeの起点と刻みは標準ライブラリごとに違うので、UNIX時刻からのナノ秒にそろえる */
+#if (__cplusplus >= 202002L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 202002L))
+    const auto system_time = std::filesystem::file_time_type::clock::to_sys(time);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(system_time.time_since_epoch()).count();
+#else
+    /* 刻みのままずらしてからナノ秒にする(先にナノ秒にするとMSVCの値は桁あふれする) */
+    const auto since_unix = time.time_since_epoch() + std::chrono::seconds(GS_FILE_CLOCK_TO_UNIX_SEC);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(since_unix).count();
+#endif
+}
+
+static void push_path(GsScanState& state, size_t& next_queue, std::string file_path)
+{
+    /* 見つけたファイルは待ち行列に順に振り分ける */
+    GsScanQueue& queue = *state.queues[next_queue];
+    next_queue = (next_queue + 1) % state.queues.size();
+    /* 取り出したスレッドが先に減らして0を下回らないよう、待ち行列に入れる前に数える */
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.paths.push_back(std::move(file_path));
+    }
+    state.condition.notify_one();
+}
+
+template <typename Visitor>
+static bool walk(const std::string& root_path, const bool is_recursive, const Visitor& visit)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path root = fs::u8path(root_path);
+    if (!fs::is_directory(root, error)) {
+        return false;
+    }
+    /* 1つのエントリの種類を調べられなくても、たどるのはやめない */
+    std::error_code entry_error;
+    const fs::directory_options options = fs::directory_options::skip_permission_denied;
+    if (is_recursive) {
+        fs::recursive_directory_iterator it(root, options, error);
+        for (; !error && (it != fs::recursive_directory_iterator()); it.increment(error)) {
+            if (it->is_regular_file(entry_error)) {
+                visit(*it);
+            }
+        }
+    } else {
+        fs::directory_iterator it(root, options, error);
+        for (; !error && (it != fs::directory_iterator()); it.increment(error)) {
+            if (it->is_regular_file(entry_error)) {
+                visit(*it);
+            }
+        }
+    }
+    return !error;
+}
+
+template <typename Producer>
+static bool run_scan(const GsPatchScanConfig& config, const GsPatchHandler& handler, const Producer& produce)
+{
+    unsigned int thread_count = config.thread_count;
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    GsScanState state;
+    for (unsigned int i = 0; i < thread_count; i++) {
+        state.queues.push_back(std::make_unique<GsScanQueue>());
+    }
+    /* ファイルを探しながら読み始められるよう、先にスレッドを起こしておく */
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (unsigned int i = 0; i < thread_count; i++) {
+        workers.emplace_back(run_worker, std::ref(state), static_cast<size_t>(i), std::cref(handler));
+    }
+    const bool result = produce(state);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.is_walking = false;
+    }
+    state.condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return result;
+}
+
+/****************************************************************
+ * クラス定義
+ ****************************************************************/
+bool gspatch_scanner::scan(const std::string& root_path, const GsPatchScanConfig& config, const GsPatchHandler& handler)
+{
+    return run_scan(config, handler, [&root_path, &config](GsScanState& state) {
+        size_t next_queue = 0;
+        return walk(root_path, config.is_recursive, [&state, &next_queue](const std::filesystem::directory_entry& entry) {
+            std::string file_path = to_utf8(entry.path());
+            if (is_patch_file(file_path)) {
+                push_path(state, next_queue, std::move(file_path));
+            }
+        });
+    });
+}
+
+bool gspatch_scanner::scan_files(const std::vector<std::string>& file_paths, const GsPatchScanConfig& config,
+    const GsPatchHandler& handler)
+{
+    return run_scan(config, handler, [&file_paths](GsScanState& state) {
+        size_t next_queue = 0;
+        for (const auto& file_path : file_paths) {
+            push_path(state, next_queue, file_path);
+        }
+        return true;
+    });
+}
+
+bool gspatch_scanner::find_files(const std::string& root_path, const bool is_recursive, std::vector<GsPatchFile>& files)
+{
+    files.clear();
+    return walk(root_path, is_recursive, [&files](const std::filesystem::directory_entry& entry) {
+        std::string file_path = to_utf8(entry.path());
+        if (!is_patch_file(file_path)) {
+            return;
+        }
+        /* 大きさと更新時刻は、たどるときに取得済みであればそれを使う */
+        std::error_code error;
+        GsPatchFile file;
+        file.filepath = std::move(file_path);
+        file.file_size = static_cast<uint64_t>(entry.file_size(error));
+        file.modified_time = to_unix_nanoseconds(entry.last_write_time(error));
+        files.push_back(std::move(file));
+    });
+}
+
+bool gspatch_scanner::scan(const std::string& root_path, const GsPatchScanConfig& config, std::vector<GameSynthPatchData>& catalog)
+{
+    catalog.clear();
+    std::mutex mutex;
+    const bool result = scan(root_path, config, [&catalog, &mutex](bool is_parsed, const GameSynthPatchData& gspatch_data) {
+        if (!is_parsed) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        catalog.push_back(gspatch_data);
+    });
+    /* 読み終わる順はスレッドの数で変わるので、ファイルパスの順にそろえる */
+    std::sort(catalog.begin(), catalog.end(), [](const GameSynthPatchData& left, const GameSynthPatchData& right) {
+        return left.filepath < right.filepath;
+    });
+    return result;
+}
+
+bool gspatch_scanner::is_patch_file(const std::string& file_path)
+{
+    static constexpr std::string_view extension = "." GSPATCH_PREFIX;
+    if (file_path.size() < extension.size()) {
+        return false;
+    }
+    const std::string_view tail = std::string_view(file_path).substr(file_path.size() - extension.size());
+    return std::equal(tail.begin(), tail.end(), extension.begin(), [](const char left, const char right) {
+        return std::tolower(static_cast<unsigned char>(left)) == right;
+    });
+}
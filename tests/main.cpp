@@ -1,7 +1,7 @@
 ﻿/****************************************************************
  * @file    main.cpp
  * @brief   gsmoduleのテスト
- * @version 1.0.8
+ * @version 1.0.43
  * @auther  ysd
  ****************************************************************/
 
@@ -10,7 +10,34 @@
  ****************************************************************/
 #include <gsapi_commands.h>
 #include <gsapi_client.h>
+#include <gsapi_async_client.h>
+#include <gsapi_codec.h>
+#include <gsapi_coroutine.h>
+#include <gsapi_curve.h>
+#include <gsapi_curve_state.h>
+#include <gsapi_drawing.h>
+#include <gsapi_meta_coalescer.h>
+#include <gsapi_pool.h>
+#include <gsapi_session.h>
+#include <gspatch_catalog.h>
+#include <gspatch_parser.h>
+#include <gspatch_reader.h>
+#include <gspatch_scanner.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <iostream>
 
 /****************************************************************
@@ -39,11 +66,40 @@
 #define TEST_SAVE_FILE_NAME             "TestPatch.gspatch"
 #define TEST_RENDER_FILE_NAME           "TestPatch.wav"
 
+/* gspatchの解析のテストで書き出すファイル */
+#define TEST_PARSE_FILE_NAME            "ParsePatch.gspatch"
+#define TEST_LIBRARY_DIRECTORY          "PatchLibrary"
+#define TEST_CATALOG_FILE_NAME          "PatchLibrary.gscatalog"
+
  /****************************************************************
   * 変数定義
   ****************************************************************/
 std::string source_path;
 
+/* gspatchの解析のテストで使用するパッチ */
+const std::string test_patch_text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<GameSynthPatch ToolVersion="2024.1">
+  <Patch PatchName="Whoosh" PatchVersion="3">
+    <Author value="ysd"/>
+    <UCS category="WHOOSH" subCategory="SWISH"/>
+    <AlgoParameters>
+      <Param name="Speed" value="0.5"/>
+    </AlgoParameters>
+    <Parameters>
+      <Param name="Gain" value="-3"/>
+      <Param name="Pan" value="0"/>
+    </Parameters>
+    <MetaParameters>
+      <Meta name="Intensity" value="0.25"><Link target="Gain"/></Meta>
+    </MetaParameters>
+    <AutomationCurves>
+      <Curve name="Pitch">(0,0),(1,1)</Curve>
+    </AutomationCurves>
+    <RandomPlay enabled="1"/>
+  </Patch>
+</GameSynthPatch>
+)";
+
 /****************************************************************
  * クラス定義
  ****************************************************************/
@@ -98,12 +154,916 @@ TEST_F(GSAPI_TEST, TEST_SEND_COMMAND) {
     EXPECT_EQ(res, true);
 };
 
+/* 応答をデリミタまで受信し、デリミタを含めずに受け取るテスト */
+TEST_F(GSAPI_TEST, TEST_SEND_COMMAND_FRAMED) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    const std::string command = std::string("get_version") + gs_config.delimiter;
+    std::string response = "";
+    const bool res = gsapi_client::send_command(command, response);
+    std::cout << response << std::endl;
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(response.find(gs_config.delimiter), std::string::npos);
+};
+
+/* 応答が届かないときは設定した期限で待機を打ち切るテスト */
+TEST_F(GSAPI_TEST, TEST_SEND_COMMAND_DEADLINE) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    GsApiClientConfig short_config = gs_config;
+    short_config.receive_timeout_msec = 200;
+    gsapi_client::set_default_config(short_config);
+    const std::string command = "get_version"; /* デリミタが無いのでツールは応答しない */
+    std::string response = "";
+    const auto start = std::chrono::steady_clock::now();
+    const bool res = gsapi_client::send_command(command, response);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    gsapi_client::set_default_config(gs_config);
+    EXPECT_EQ(res, true);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+};
+
 /* ツールと通信可能か */
 TEST_F(GSAPI_TEST, TEST_GS_CONNECT) {
     const bool res = gsapi_client::is_connect();
     EXPECT_EQ(res, true);
 };
 
+/* 同じ接続でコマンドを繰り返し送信できるか */
+TEST_F(GSAPI_TEST, TEST_GS_REUSE_CONNECTION) {
+    for (int i = 0; i < 100; i++) {
+        std::string version;
+        const bool res = gsapi_client::command_get_version(version);
+        EXPECT_EQ(res, true);
+    }
+};
+
+/* パイプラインでコマンドをまとめて送信し、応答を順に受け取る */
+TEST_F(GSAPI_TEST, TEST_GS_PIPELINE) {
+    bool res = gsapi_client::begin_pipeline();
+    EXPECT_EQ(res, true);
+    for (unsigned int i = 0; i < 10; i++) {
+        res = gsapi_client::command_set_metavalue(0, 0.1f * i);
+        EXPECT_EQ(res, true);
+    }
+    /* 取得系コマンドは蓄積されるが、値は受け取れない */
+    std::string version;
+    res = gsapi_client::command_get_version(version);
+    EXPECT_EQ(res, false);
+    float variation = 0.f;
+    res = gsapi_client::command_get_variation(variation);
+    EXPECT_EQ(res, false);
+    std::vector<std::string> responses;
+    res = gsapi_client::end_pipeline(responses);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(responses.size(), 12u);
+    std::cout << responses[10] << std::endl;
+};
+
+/* 読み戻すと同じ値になる表記で、同じ文字列の容量を使い回してメッセージを作成するか */
+TEST_F(GSAPI_TEST, TEST_GS_ENCODE) {
+    const std::string delimiter = GsApiClientConfig().delimiter;
+    std::string message;
+    message.reserve(256);
+    const char* buffer = message.data();
+    const float values[] = { 1.f / 3.f, 0.1f, -2.5e-7f, 123456.789f };
+    for (const float value : values) {
+        bool res = gsapi_codec::encode_set_metavalue(0u, value, delimiter, message);
+        EXPECT_EQ(res, true);
+        EXPECT_EQ(message.data(), buffer);
+        const std::string prefix = std::string(GSAPI_SET_METAVALUE) + " BY_INDEX 0 ";
+        ASSERT_EQ(message.compare(0, prefix.size(), prefix), 0);
+        const float parsed = std::strtof(message.c_str() + prefix.size(), nullptr);
+        EXPECT_EQ(parsed, value);
+    }
+    bool res = gsapi_codec::encode_render_patch("a.wav", 16, 2, 1500, delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, std::string(GSAPI_RENDER_PATCH) + " a.wav 16 2 1500" + delimiter);
+    EXPECT_EQ(message.data(), buffer);
+};
+
+/* コマンドの一覧から、コマンド名と引数を並べたメッセージを作成するか */
+TEST_F(GSAPI_TEST, TEST_GS_COMMAND_TABLE) {
+    EXPECT_EQ(gsapi_is_valid_command_table(), true);
+    EXPECT_EQ(gsapi_command(GS_COMMAND_WINDOW_RENDERING).name, GSAPI_WINDOW_RENDERING);
+    EXPECT_EQ(gsapi_command(GS_COMMAND_GET_CURVEVALUE).reply, GS_REPLY_CURVEVALUE);
+    EXPECT_EQ((std::is_same_v<GsReplyValue<GS_COMMAND_GET_CURVEVALUE>, GsCurveValue>), true);
+    EXPECT_EQ((std::is_same_v<GsReplyValue<GS_COMMAND_WINDOW_MESSAGE>, std::string>), true);
+    EXPECT_EQ((std::is_void_v<GsReplyValue<GS_COMMAND_PLAY>>), true);
+    EXPECT_EQ((gsapi_is_command_args<GS_COMMAND_SET_METAVALUE, GsByName, float>()), true);
+    EXPECT_EQ((gsapi_is_command_args<GS_COMMAND_SET_METAVALUE, GsByQuotedName, float>()), false);
+    EXPECT_EQ((gsapi_is_command_args<GS_COMMAND_RENDER_PATCH, std::string, unsigned int>()), false);
+    std::vector<std::string_view> names;
+    EXPECT_EQ(gsapi_codec::decode_reply<GS_COMMAND_GET_METANAMES>("a,b", names), true);
+    EXPECT_EQ(names.size(), 2u);
+    unsigned int count = 0;
+    EXPECT_EQ(gsapi_codec::decode_reply<GS_COMMAND_GET_CURVESCOUNT>("x", count), false);
+
+    const std::string delimiter = GsApiClientConfig().delimiter;
+    std::string message;
+    bool res = gsapi_codec::encode_window_rendering(true, false, delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, "window_rendering 1 0" + delimiter);
+    res = gsapi_codec::encode_window_message("hello", GS_WINDOW_BUTTON_YES_NO, delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, "window_message hello YES_NO" + delimiter);
+    GsCurveValue curve_value;
+    curve_value.curve.resize(2);
+    curve_value.curve[1].x = 1.f;
+    curve_value.curve[1].y = 0.5f;
+    curve_value.duration = 2.f;
+    curve_value.is_loop = true;
+    res = gsapi_codec::encode_set_curvevalue("Curve 1", curve_value, delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, "set_curvevalue BY_NAME \"Curve 1\" \"(0,0),(1,0.5)\" 2 1" + delimiter);
+    res = gsapi_codec::encode_window_message("hello", static_cast<GsWindowButton>(10), delimiter, message);
+    EXPECT_EQ(res, false);
+    res = gsapi_codec::encode_get_metavalue(std::string("Intensity"), delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, "get_metavalue BY_NAME Intensity" + delimiter);
+    GsBool gs_bool;
+    gs_bool.name = "On";
+    GsEnum gs_enum;
+    gs_enum.name = "Mode";
+    gs_enum.choices = { "A", "B" };
+    gs_enum.default_choice = 1;
+    res = gsapi_codec::encode_window_parameters({ gs_bool, GsEnum(), gs_enum }, delimiter, message);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(message, "window_parameters {BOOL,\"On\",TRUE} {ENUM,\"Mode\",LIST,\"A, B\",B}" + delimiter);
+};
+
+/* 一覧の応答をコピーせずに受け取り、コピーした場合と同じ内容になるか */
+TEST_F(GSAPI_TEST, TEST_GS_LIST_VIEW) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_session session(gs_config);
+    std::vector<std::string> command_list;
+    bool res = session.command_get_commands(command_list);
+    EXPECT_EQ(res, true);
+    std::vector<std::string_view> command_views;
+    res = session.command_get_commands(command_views);
+    EXPECT_EQ(res, true);
+    ASSERT_EQ(command_views.size(), command_list.size());
+    for (size_t i = 0; i < command_views.size(); i++) {
+        EXPECT_EQ(command_views[i], command_list[i]);
+    }
+
+    std::vector<std::string_view> tokens;
+    gsapi_codec::decode_list("a,,b,", tokens);
+    ASSERT_EQ(tokens.size(), 3u);
+    EXPECT_EQ(tokens[0], "a");
+    EXPECT_EQ(tokens[1], "");
+    EXPECT_EQ(tokens[2], "b");
+};
+
+/* パッチの情報を覚え、問い合わせた場合と同じ値を返せるか */
+TEST_F(GSAPI_TEST, TEST_GS_MIRROR_CACHE) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_session direct_session(gs_config);
+    gs_config.mirror_cache = true;
+    gsapi_session mirror_session(gs_config);
+
+    std::vector<std::string> expected_names;
+    EXPECT_EQ(direct_session.command_get_metanames(expected_names), true);
+    unsigned int expected_count = 0;
+    EXPECT_EQ(direct_session.command_get_curvescount(expected_count), true);
+    std::string expected_patch;
+    EXPECT_EQ(direct_session.command_get_patchname(expected_patch), true);
+
+    for (int i = 0; i < 2; i++) {
+        /* 1回目は問い合わせて覚え、2回目は覚えた値を返す */
+        std::vector<std::string> meta_names;
+        EXPECT_EQ(mirror_session.command_get_metanames(meta_names), true);
+        EXPECT_EQ(meta_names, expected_names);
+        std::vector<std::string_view> meta_views;
+        EXPECT_EQ(mirror_session.command_get_metanames(meta_views), true);
+        ASSERT_EQ(meta_views.size(), expected_names.size());
+        for (size_t j = 0; j < meta_views.size(); j++) {
+            EXPECT_EQ(meta_views[j], expected_names[j]);
+        }
+        unsigned int curves_count = 0;
+        EXPECT_EQ(mirror_session.command_get_curvescount(curves_count), true);
+        EXPECT_EQ(curves_count, expected_count);
+        std::string patch_name;
+        EXPECT_EQ(mirror_session.command_get_patchname(patch_name), true);
+        EXPECT_EQ(patch_name, expected_patch);
+    }
+    mirror_session.invalidate_mirror();
+    std::string patch_name;
+    EXPECT_EQ(mirror_session.command_get_patchname(patch_name), true);
+    EXPECT_EQ(patch_name, expected_patch);
+
+    /* 問い合わせた場合も覚えた一覧を返す場合も、前の要素を残して末尾に追加する */
+    std::vector<std::string> appended_expected(1, "previous");
+    appended_expected.insert(appended_expected.end(), expected_names.begin(), expected_names.end());
+    for (int i = 0; i < 2; i++) {
+        std::vector<std::string> meta_names(1, "previous");
+        EXPECT_EQ(mirror_session.command_get_metanames(meta_names), true);
+        EXPECT_EQ(meta_names, appended_expected);
+        std::vector<std::string_view> meta_views(1, "previous");
+        EXPECT_EQ(mirror_session.command_get_metanames(meta_views), true);
+        ASSERT_EQ(meta_views.size(), appended_expected.size());
+        for (size_t j = 0; j < meta_views.size(); j++) {
+            EXPECT_EQ(meta_views[j], appended_expected[j]);
+        }
+    }
+};
+
+/* 名前の指定をインデックスに変換し、パッチにない名前は送らずに失敗するか */
+TEST_F(GSAPI_TEST, TEST_GS_RESOLVE_NAMES) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_session direct_session(gs_config);
+    gs_config.resolve_names = true;
+    gsapi_session resolve_session(gs_config);
+
+    std::vector<std::string> meta_names;
+    EXPECT_EQ(direct_session.command_get_metanames(meta_names), true);
+    for (const auto& name : meta_names) {
+        float expected = 0.f;
+        float metavalue = 0.f;
+        EXPECT_EQ(direct_session.command_get_metavalue(name, expected), true);
+        EXPECT_EQ(resolve_session.command_get_metavalue(name, metavalue), true);
+        EXPECT_EQ(metavalue, expected);
+        EXPECT_EQ(resolve_session.command_set_metavalue(name, metavalue), true);
+    }
+    EXPECT_EQ(resolve_session.command_set_metavalue(std::string("__unknown_meta__"), 0.f), false);
+    GsCurveValue curve_value;
+    EXPECT_EQ(resolve_session.command_get_curvevalue(std::string("__unknown_curve__"), curve_value), false);
+
+    /* 一覧の応答が期限までに届かなければ表を作らず、名前のまま送る */
+    GsApiClientConfig timeout_config = gs_config;
+    timeout_config.delimiter = "\n"; /* ツールのデリミタと違うのでツールは応答しない */
+    timeout_config.receive_timeout_msec = 200;
+    gsapi_session timeout_session(timeout_config);
+    EXPECT_EQ(timeout_session.command_set_metavalue(std::string("__unknown_meta__"), 0.f), true);
+    EXPECT_EQ(timeout_session.command_set_metavalue(std::string("__unknown_meta__"), 0.f), true);
+};
+
+/* まとめて設定する値に送れないものがあれば、残りを送ってfalseを返すか */
+TEST_F(GSAPI_TEST, TEST_GS_BATCH_FAILURE) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gs_config.resolve_names = true;
+    gsapi_session session(gs_config);
+
+    std::vector<GsMetaValueEntry> metavalues(3);
+    metavalues[0].target = 0u;
+    metavalues[0].value = 0.25f;
+    metavalues[1].target = std::string("__unknown_meta__");
+    metavalues[1].value = 0.5f;
+    metavalues[2].target = 0u;
+    metavalues[2].value = 0.75f;
+    EXPECT_EQ(session.command_set_metavalues(metavalues), false);
+    /* 送る前に失敗した値の位置を受け取り、残りの値は送れる */
+    std::vector<size_t> failed_indices;
+    EXPECT_EQ(session.command_set_metavalues(metavalues, failed_indices), true);
+    EXPECT_EQ(failed_indices, std::vector<size_t>(1, 1));
+    metavalues.erase(metavalues.begin() + 1);
+    EXPECT_EQ(session.command_set_metavalues(metavalues), true);
+    EXPECT_EQ(session.command_set_metavalues(metavalues, failed_indices), true);
+    EXPECT_EQ(failed_indices.empty(), true);
+
+    std::vector<GsCurveValueEntry> curve_values(2);
+    curve_values[0].target = 0u;
+    curve_values[0].value.curve = { {0,0}, {1,1} };
+    curve_values[1].target = std::string("__unknown_curve__");
+    curve_values[1].value.curve = { {0,1}, {1,0} };
+    EXPECT_EQ(session.command_set_curvevalues(curve_values), false);
+
+    /* 送る前に失敗した曲線は溜めずに捨て、次のflushで送り直さない */
+    gsapi_curve_state curve_state(session);
+    EXPECT_EQ(curve_state.stage(std::string("__unknown_curve__"), curve_values[1].value), true);
+    EXPECT_EQ(curve_state.stage(0u, curve_values[0].value), true);
+    EXPECT_EQ(curve_state.flush(), false);
+    EXPECT_EQ(curve_state.dirty_count(), 0u);
+    EXPECT_EQ(curve_state.flush(), true);
+    EXPECT_EQ(curve_state.stage(0u, curve_values[0].value), false);
+
+    /* 通信に失敗したら、ツール側の曲線はわからないので前に送った曲線でも送り直す */
+    GsApiClientConfig closed_config = gs_config;
+    closed_config.port_number = 1;
+    session.set_config(closed_config);
+    EXPECT_EQ(curve_state.stage(0u, curve_values[1].value), true);
+    EXPECT_EQ(curve_state.flush(), false);
+    EXPECT_EQ(curve_state.dirty_count(), 1u);
+    session.set_config(gs_config);
+    EXPECT_EQ(curve_state.stage(0u, curve_values[0].value), true);
+    EXPECT_EQ(curve_state.flush(), true);
+
+    /* まとめたメタパラメータも、送る前に失敗した値は捨て、通信に失敗した値だけを残す */
+    gsapi_meta_coalescer coalescer(session);
+    coalescer.command_set_metavalue(std::string("__unknown_meta__"), 0.5f);
+    coalescer.command_set_metavalue(0u, 0.5f);
+    EXPECT_EQ(coalescer.flush(), false);
+    EXPECT_EQ(coalescer.pending_count(), 0u);
+    session.set_config(closed_config);
+    coalescer.command_set_metavalue(0u, 0.25f);
+    EXPECT_EQ(coalescer.flush(), false);
+    EXPECT_EQ(coalescer.pending_count(), 1u);
+    session.set_config(gs_config);
+    EXPECT_EQ(coalescer.flush(), true);
+    EXPECT_EQ(coalescer.pending_count(), 0u);
+};
+
+/* 曲線の応答を解析し、形式が合わない点は読み飛ばすか */
+TEST_F(GSAPI_TEST, TEST_GS_DECODE_POINTS) {
+    std::vector<GsDrawingData> drawing_data;
+    bool res = gsapi_codec::decode_drawing("(0,0,0,0),(1,2,3),(x,1,1,1),(0.5, 0.25,0.125,1),(1,1,1,1", drawing_data);
+    EXPECT_EQ(res, true);
+    ASSERT_EQ(drawing_data.size(), 3u);
+    EXPECT_EQ(drawing_data[1].x, 0.25f);
+    EXPECT_EQ(drawing_data[1].y, 0.125f);
+    EXPECT_EQ(drawing_data[2].t, 1.f);
+
+    GsCurveValue curve_value;
+    res = gsapi_codec::decode_curvevalue("\"(0,0),(0.5,0.75),(1,1)\" 0.56 1", curve_value);
+    EXPECT_EQ(res, true);
+    ASSERT_EQ(curve_value.curve.size(), 3u);
+    EXPECT_EQ(curve_value.curve[1].y, 0.75f);
+    EXPECT_EQ(curve_value.duration, 0.56f);
+    EXPECT_EQ(curve_value.is_loop, true);
+    res = gsapi_codec::decode_curvevalue("\"(0,0)\" 0.56", curve_value);
+    EXPECT_EQ(res, false);
+};
+
+/* 要素ごとの配列で曲線を加工し、そのまま送受信できるか */
+TEST_F(GSAPI_TEST, TEST_GS_DRAWING_BUFFER) {
+    std::vector<GsDrawingData> points(3);
+    points[0].t = 1.f; points[0].x = 2.f; points[0].y = 1.f; points[0].p = 0.25f;
+    points[1].t = 2.f; points[1].x = 4.f; points[1].y = 1.f; points[1].p = 2.f;
+    points[2].t = 3.f; points[2].x = 6.f; points[2].y = 1.f; points[2].p = 1.f;
+    GsDrawingBuffer buffer;
+    gsapi_drawing::from_points(points, buffer);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.x.data()) % GSAPI_DRAWING_ALIGNMENT, 0u);
+
+    EXPECT_EQ(gsapi_drawing::normalize(buffer), true);
+    EXPECT_EQ(buffer.t[0], 0.f);
+    EXPECT_EQ(buffer.x[1], 0.5f);
+    EXPECT_EQ(buffer.x[2], 1.f);
+    EXPECT_EQ(buffer.y[0], 0.5f);
+    EXPECT_EQ(gsapi_drawing::scale_time(buffer, 2.f, 0.f), true);
+    EXPECT_EQ(buffer.t[2], 4.f);
+    EXPECT_EQ(gsapi_drawing::apply_pressure_curve(buffer, 2.f), true);
+    EXPECT_EQ(buffer.p[0], 0.0625f);
+    EXPECT_EQ(buffer.p[1], 1.f);
+
+    GsDrawingBuffer resampled;
+    EXPECT_EQ(gsapi_drawing::resample(buffer, 2.f, resampled), true);
+    ASSERT_EQ(gsapi_drawing::size(resampled), 9u);
+    EXPECT_EQ(resampled.t[1], 0.5f);
+    EXPECT_EQ(resampled.x[1], 0.125f);
+    EXPECT_EQ(resampled.x[8], 1.f);
+
+    bool res = gsapi_client::command_set_drawing(resampled);
+    EXPECT_EQ(res, true);
+    GsDrawingBuffer received;
+    res = gsapi_client::command_get_drawing(0, received);
+    EXPECT_EQ(res, true);
+    std::vector<GsDrawingData> received_points;
+    gsapi_client::command_get_drawing(0, received_points);
+    EXPECT_EQ(gsapi_drawing::size(received), received_points.size());
+};
+
+/* オートメーションカーブの点を許容誤差か上限まで減らしてから送れるか */
+TEST_F(GSAPI_TEST, TEST_GS_CURVE_SIMPLIFY) {
+    std::vector<GsCurvePoint> source(1000);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i].x = static_cast<float>(i) / (source.size() - 1);
+        source[i].y = 0.5f + 0.5f * std::sin(source[i].x * 6.2831853f);
+    }
+    std::vector<GsCurvePoint> simplified;
+    gsapi_curve::simplify(source, 0.01f, 0, simplified);
+    EXPECT_LT(simplified.size(), 50u);
+    EXPECT_GT(simplified.size(), 4u);
+    EXPECT_EQ(simplified.front().x, 0.f);
+    EXPECT_EQ(simplified.back().x, 1.f);
+    for (const auto& point : source) {
+        /* 残した線分からの縦のずれは許容誤差程度に収まる */
+        auto it = std::lower_bound(simplified.begin(), simplified.end(), point.x,
+            [](const GsCurvePoint& kept, const float x) { return kept.x < x; });
+        if (it == simplified.begin()) {
+            continue;
+        }
+        const GsCurvePoint& right = *it;
+        const GsCurvePoint& left = *(it - 1);
+        const float y = left.y + (right.y - left.y) * (point.x - left.x) / (right.x - left.x);
+        EXPECT_LT(std::fabs(y - point.y), 0.05f);
+    }
+    gsapi_curve::simplify(source, 0.f, 10, simplified);
+    EXPECT_EQ(simplified.size(), 10u);
+
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gs_config.curve_max_points = 16;
+    gsapi_session session(gs_config);
+    GsCurveValue curve_value;
+    curve_value.curve = source;
+    curve_value.duration = 1.f;
+    const bool res = session.command_set_curvevalue(0, curve_value);
+    EXPECT_EQ(res, true);
+};
+
+/* 送ったオートメーションカーブを覚え、変わった曲線だけを送れるか */
+TEST_F(GSAPI_TEST, TEST_GS_CURVE_STATE) {
+    gsapi_session session;
+    gsapi_curve_state curve_state(session);
+    GsCurveValue curve_value;
+    curve_value.curve = { {0.f, 0.f}, {0.5f, 1.f}, {1.f, 0.f} };
+    curve_value.duration = 1.f;
+    EXPECT_EQ(curve_state.command_set_curvevalue(0u, curve_value), true);
+    /* 同じ曲線は溜めない */
+    EXPECT_EQ(curve_state.stage(0u, curve_value), false);
+    EXPECT_EQ(curve_state.dirty_count(), 0u);
+
+    GsCurveValue changed = curve_value;
+    changed.curve[1].y = 0.5f;
+    EXPECT_EQ(curve_state.stage(0u, changed), true);
+    EXPECT_EQ(curve_state.stage(std::string("Curve"), curve_value), true);
+    EXPECT_EQ(curve_state.dirty_count(), 2u);
+    /* 送った曲線に戻せば、溜めた変更はなくなる */
+    EXPECT_EQ(curve_state.stage(0u, curve_value), false);
+    EXPECT_EQ(curve_state.dirty_count(), 1u);
+    EXPECT_EQ(curve_state.stage(0u, changed), true);
+    EXPECT_EQ(curve_state.flush(), true);
+    EXPECT_EQ(curve_state.dirty_count(), 0u);
+    EXPECT_EQ(curve_state.stage(0u, changed), false);
+    EXPECT_EQ(curve_state.flush(), true);
+
+    curve_state.invalidate();
+    EXPECT_EQ(curve_state.stage(0u, changed), true);
+};
+
+/* メタパラメータの値をまとめ、最新の値だけを送れるか */
+TEST_F(GSAPI_TEST, TEST_GS_META_COALESCER) {
+    gsapi_session session;
+    gsapi_meta_coalescer coalescer(session);
+    for (int i = 0; i <= 100; i++) {
+        coalescer.command_set_metavalue(0u, i / 100.f);
+        coalescer.command_set_metavalue(std::string("Meta"), i / 100.f);
+    }
+    /* 何度設定しても、残るのはメタパラメータごとに1つ */
+    EXPECT_EQ(coalescer.pending_count(), 2u);
+    EXPECT_EQ(coalescer.flush(), true);
+    EXPECT_EQ(coalescer.pending_count(), 0u);
+    EXPECT_EQ(coalescer.flush(), true);
+
+    EXPECT_EQ(coalescer.start(0), false);
+    EXPECT_EQ(coalescer.start(100), true);
+    EXPECT_EQ(coalescer.start(100), false);
+    for (int i = 0; i <= 100; i++) {
+        coalescer.command_set_metavalue(0u, i / 100.f);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    /* 送信スレッドが間隔をおいて送り切る */
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while ((coalescer.pending_count() != 0) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(coalescer.pending_count(), 0u);
+    coalescer.stop();
+};
+
+/* gspatchのヘッダーとセクションを取り出せるか */
+TEST_F(GSAPI_TEST, TEST_GS_PATCH_MODEL) {
+    GameSynthPatchData gspatch_data;
+    EXPECT_EQ(gspatch_parser::parse(test_patch_text, gspatch_data), true);
+    EXPECT_EQ(gspatch_data.tool_version, "2024.1");
+    EXPECT_EQ(gspatch_data.patch_name, "Whoosh");
+    EXPECT_EQ(gspatch_data.author, "ysd");
+    EXPECT_EQ(gspatch_data.ucs_category, "WHOOSH");
+    EXPECT_EQ(gspatch_data.ucs_sub_catebory, "SWISH");
+    EXPECT_EQ(gspatch_parser::parse("<Other/>", gspatch_data), false);
+
+    gspatch_model model;
+    ASSERT_EQ(model.parse(test_patch_text), true);
+    EXPECT_EQ(model.get_header().patch_version, "3");
+    const GsPatchSection& parameters = model.get_section(GSPATCH_SECTION_PARAMETERS);
+    EXPECT_EQ(parameters.is_found, true);
+    ASSERT_EQ(parameters.record.children.size(), 2u);
+    std::string value;
+    EXPECT_EQ(gspatch_parser::get_attribute(parameters.record.children[0], "value", value), true);
+    EXPECT_EQ(value, "-3");
+    const GsPatchSection& meta_parameters = model.get_section(GSPATCH_SECTION_META_PARAMETERS);
+    ASSERT_EQ(meta_parameters.record.children.size(), 1u);
+    EXPECT_EQ(meta_parameters.record.children[0].children.size(), 1u);
+    const GsPatchSection& curves = model.get_section(GSPATCH_SECTION_AUTOMATION_CURVES);
+    ASSERT_EQ(curves.record.children.size(), 1u);
+    EXPECT_EQ(curves.record.children[0].text, "(0,0),(1,1)");
+    EXPECT_EQ(model.get_section(GSPATCH_SECTION_EVENTS).is_found, false);
+    EXPECT_EQ(&model.get_section(GSPATCH_SECTION_PARAMETERS), &parameters);
+};
+
+/* gspatchをDOMを作らずに読み、ヘッダーがそろえば読むのをやめるか */
+TEST_F(GSAPI_TEST, TEST_GS_PATCH_READER) {
+    GameSynthPatchData expected;
+    ASSERT_EQ(gspatch_parser::parse(test_patch_text, expected), true);
+    GameSynthPatchData gspatch_data;
+    EXPECT_EQ(gspatch_parser::parse_header(test_patch_text, gspatch_data), true);
+    EXPECT_EQ(gspatch_data.tool_version, expected.tool_version);
+    EXPECT_EQ(gspatch_data.patch_name, expected.patch_name);
+    EXPECT_EQ(gspatch_data.patch_version, expected.patch_version);
+    EXPECT_EQ(gspatch_data.author, expected.author);
+    EXPECT_EQ(gspatch_data.ucs_category, expected.ucs_category);
+    EXPECT_EQ(gspatch_data.ucs_sub_catebory, expected.ucs_sub_catebory);
+
+    /* ヘッダーの後ろが壊れていても、そこまでは読まない */
+    const std::string truncated = test_patch_text.substr(0, test_patch_text.find("<Param "));
+    GameSynthPatchData truncated_data;
+    EXPECT_EQ(gspatch_parser::parse(truncated, truncated_data), false);
+    EXPECT_EQ(gspatch_parser::parse_header(truncated, truncated_data), true);
+    EXPECT_EQ(truncated_data.ucs_sub_catebory, "SWISH");
+
+    gspatch_reader reader("<?xml version=\"1.0\"?><!-- c --><a x=\"1 &amp; 2\" y='&#x41;'><b/>t<![CDATA[<c>]]></a>");
+    GsPatchToken token;
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.type, GSPATCH_TOKEN_START);
+    EXPECT_EQ(token.name, "a");
+    ASSERT_EQ(token.attributes.size(), 2u);
+    std::string value;
+    gspatch_reader::unescape(token.attributes[0].value, value);
+    EXPECT_EQ(value, "1 & 2");
+    gspatch_reader::unescape(token.attributes[1].value, value);
+    EXPECT_EQ(value, "A");
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.type, GSPATCH_TOKEN_START);
+    EXPECT_EQ(token.depth, 2u);
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.type, GSPATCH_TOKEN_END);
+    EXPECT_EQ(token.name, "b");
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.text, "t");
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.text, "<c>");
+    ASSERT_EQ(reader.next(token), true);
+    EXPECT_EQ(token.type, GSPATCH_TOKEN_END);
+    EXPECT_EQ(reader.next(token), false);
+    EXPECT_EQ(reader.is_error(), false);
+
+    gspatch_reader broken_reader("<a><b></a>");
+    while (broken_reader.next(token)) {
+    }
+    EXPECT_EQ(broken_reader.is_error(), true);
+};
+
+/* gspatchファイルをメモリに割り当てて、ヘッダーを複製せずに読めるか */
+TEST_F(GSAPI_TEST, TEST_GS_PATCH_FILE) {
+    {
+        std::ofstream stream(TEST_PARSE_FILE_NAME, std::ios::binary);
+        stream << test_patch_text;
+    }
+    GameSynthPatchData gspatch_data;
+    EXPECT_EQ(gspatch_parser::parse_file(TEST_PARSE_FILE_NAME, gspatch_data), true);
+    EXPECT_EQ(gspatch_data.filepath, TEST_PARSE_FILE_NAME);
+    EXPECT_EQ(gspatch_data.ucs_category, "WHOOSH");
+
+    gspatch_arena arena(16);
+    {
+        gspatch_file file;
+        GameSynthPatchView gspatch_view;
+        EXPECT_EQ(gspatch_parser::parse_file(TEST_PARSE_FILE_NAME, file, gspatch_view, arena), true);
+        /* 値は割り当てたファイルを指す */
+        const std::string_view text = file.view();
+        EXPECT_GE(gspatch_view.patch_name.data(), text.data());
+        EXPECT_LT(gspatch_view.patch_name.data(), text.data() + text.size());
+        EXPECT_EQ(gspatch_view.patch_name, "Whoosh");
+    }
+    GameSynthPatchView gspatch_view;
+    EXPECT_EQ(gspatch_parser::parse_file(TEST_PARSE_FILE_NAME, gspatch_view, arena), true);
+    EXPECT_EQ(gspatch_view.filepath, TEST_PARSE_FILE_NAME);
+    EXPECT_EQ(gspatch_view.author, "ysd");
+    EXPECT_EQ(gspatch_view.ucs_sub_catebory, "SWISH");
+
+    std::string escaped = test_patch_text;
+    escaped.replace(escaped.find("value=\"ysd\""), 11, "value=\"y&amp;d\"");
+    EXPECT_EQ(gspatch_parser::parse_header(escaped, gspatch_view, arena), true);
+    EXPECT_EQ(gspatch_view.author, "y&d");
+    EXPECT_EQ(gspatch_parser::parse_file("NotFound.gspatch", gspatch_view, arena), false);
+    std::remove(TEST_PARSE_FILE_NAME);
+};
+
+/* パッチライブラリのgspatchファイルを並列に読めるか */
+TEST_F(GSAPI_TEST, TEST_GS_PATCH_SCANNER) {
+    namespace fs = std::filesystem;
+    fs::remove_all(TEST_LIBRARY_DIRECTORY);
+    const size_t file_count = 200;
+    for (size_t i = 0; i < file_count; i++) {
+        const fs::path directory = fs::path(TEST_LIBRARY_DIRECTORY) / ("Category" + std::to_string(i % 7)) / ("Sub" + std::to_string(i % 3));
+        fs::create_directories(directory);
+        std::string text = test_patch_text;
+        text.replace(text.find("PatchName=\"Whoosh\""), 18, "PatchName=\"Patch" + std::to_string(i) + "\"");
+        std::ofstream stream(directory / ("Patch" + std::to_string(i) + ".GSPATCH"), std::ios::binary);
+        stream << text;
+    }
+    std::ofstream(fs::path(TEST_LIBRARY_DIRECTORY) / "Readme.txt") << "not a patch";
+    std::ofstream(fs::path(TEST_LIBRARY_DIRECTORY) / "Broken.gspatch") << "<GameSynthPatch";
+
+    GsPatchScanConfig config;
+    config.thread_count = 4;
+    std::atomic<size_t> parsed_count(0);
+    std::atomic<size_t> failed_count(0);
+    EXPECT_EQ(gspatch_scanner::scan(TEST_LIBRARY_DIRECTORY, config, [&](bool result, const GameSynthPatchData& gspatch_data) {
+        (result ? parsed_count : failed_count)++;
+        EXPECT_EQ(gspatch_scanner::is_patch_file(gspatch_data.filepath), true);
+    }), true);
+    EXPECT_EQ(parsed_count.load(), file_count);
+    EXPECT_EQ(failed_count.load(), 1u);
+
+    std::vector<GameSynthPatchData> catalog;
+    config.thread_count = 0;
+    EXPECT_EQ(gspatch_scanner::scan(TEST_LIBRARY_DIRECTORY, config, catalog), true);
+    ASSERT_EQ(catalog.size(), file_count);
+    EXPECT_EQ(std::is_sorted(catalog.begin(), catalog.end(), [](const GameSynthPatchData& left, const GameSynthPatchData& right) {
+        return left.filepath < right.filepath;
+    }), true);
+    EXPECT_EQ(catalog[0].ucs_category, "WHOOSH");
+
+    config.is_recursive = false;
+    EXPECT_EQ(gspatch_scanner::scan(TEST_LIBRARY_DIRECTORY, config, catalog), true);
+    EXPECT_EQ(catalog.size(), 0u);
+    EXPECT_EQ(gspatch_scanner::scan("NotFoundLibrary", config, catalog), false);
+    fs::remove_all(TEST_LIBRARY_DIRECTORY);
+};
+
+/* 一覧ファイルを保存して読み直し、変わったファイルだけを読み直すか */
+TEST_F(GSAPI_TEST, TEST_GS_PATCH_CATALOG) {
+    namespace fs = std::filesystem;
+    fs::remove_all(TEST_LIBRARY_DIRECTORY);
+    const size_t file_count = 20;
+    for (size_t i = 0; i < file_count; i++) {
+        const fs::path directory = fs::path(TEST_LIBRARY_DIRECTORY) / ("Category" + std::to_string(i % 3));
+        fs::create_directories(directory);
+        std::ofstream stream(directory / ("Patch" + std::to_string(i) + ".gspatch"), std::ios::binary);
+        stream << test_patch_text;
+    }
+    std::ofstream(fs::path(TEST_LIBRARY_DIRECTORY) / "Broken.gspatch") << "<GameSynthPatch";
+
+    GsPatchScanConfig config;
+    gspatch_catalog catalog;
+    EXPECT_EQ(catalog.update(TEST_LIBRARY_DIRECTORY, config), true);
+    EXPECT_EQ(catalog.get_parsed_count(), file_count + 1);
+    ASSERT_EQ(catalog.get_entries().size(), file_count + 1);
+    EXPECT_EQ(catalog.save(TEST_CATALOG_FILE_NAME), true);
+
+    /* 読み直した一覧は変わっていないので、どのファイルも読まない */
+    gspatch_catalog loaded;
+    EXPECT_EQ(loaded.load(TEST_CATALOG_FILE_NAME), true);
+    ASSERT_EQ(loaded.get_entries().size(), file_count + 1);
+    EXPECT_EQ(loaded.update(TEST_LIBRARY_DIRECTORY, config), true);
+    EXPECT_EQ(loaded.get_parsed_count(), 0u);
+    const std::string patch_path = (fs::path(TEST_LIBRARY_DIRECTORY) / "Category0" / "Patch0.gspatch").string();
+    const GsCatalogEntry* entry = loaded.find(patch_path);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->is_parsed, true);
+    EXPECT_EQ(entry->data.author, "ysd");
+    EXPECT_EQ(entry->data.ucs_sub_catebory, "SWISH");
+    /* 更新時刻は標準ライブラリによらずUNIX時刻からのナノ秒 */
+    const int64_t now_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_LT(std::llabs(now_nsec - entry->modified_time), 3600LL * 1000 * 1000 * 1000);
+    entry = loaded.find((fs::path(TEST_LIBRARY_DIRECTORY) / "Broken.gspatch").string());
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->is_parsed, false);
+
+    /* 書き換えたファイルだけを読み直し、消したファイルは除く */
+    {
+        std::string text = test_patch_text;
+        text.replace(text.find("value=\"ysd\""), 11, "value=\"someone\"");
+        std::ofstream stream(patch_path, std::ios::binary);
+        stream << text;
+    }
+    fs::remove(fs::path(TEST_LIBRARY_DIRECTORY) / "Category1" / "Patch1.gspatch");
+    EXPECT_EQ(loaded.update(TEST_LIBRARY_DIRECTORY, config), true);
+    EXPECT_EQ(loaded.get_parsed_count(), 1u);
+    EXPECT_EQ(loaded.get_entries().size(), file_count);
+    entry = loaded.find(patch_path);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->data.author, "someone");
+
+    /* 読み込んだ一覧ファイルに上書きしても、一覧はそのまま使える */
+    EXPECT_EQ(loaded.save(TEST_CATALOG_FILE_NAME), true);
+    entry = loaded.find(patch_path);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->data.author, "someone");
+    entry = loaded.find((fs::path(TEST_LIBRARY_DIRECTORY) / "Category2" / "Patch2.gspatch").string());
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->data.author, "ysd");
+    gspatch_catalog saved;
+    EXPECT_EQ(saved.load(TEST_CATALOG_FILE_NAME), true);
+    EXPECT_EQ(saved.get_entries().size(), file_count);
+    entry = saved.find(patch_path);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->data.author, "someone");
+
+    /* 壊れた一覧ファイルは読まない */
+    std::ofstream(TEST_CATALOG_FILE_NAME, std::ios::binary) << "GSCATLOG";
+    EXPECT_EQ(loaded.load(TEST_CATALOG_FILE_NAME), false);
+    EXPECT_EQ(loaded.get_entries().size(), 0u);
+    EXPECT_EQ(loaded.load("NotFound.gscatalog"), false);
+    std::remove(TEST_CATALOG_FILE_NAME);
+    fs::remove_all(TEST_LIBRARY_DIRECTORY);
+};
+
+/* セッションごとに別の接続で、複数のスレッドから並行してコマンドを送れるか */
+TEST_F(GSAPI_TEST, TEST_GS_SESSION_PARALLEL) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    const int session_count = 4;
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded(0);
+    for (int i = 0; i < session_count; i++) {
+        threads.emplace_back([&gs_config, &succeeded]() {
+            gsapi_session session(gs_config);
+            for (int j = 0; j < 50; j++) {
+                std::string version;
+                const bool res_version = session.command_get_version(version);
+                const bool res_metavalue = session.command_set_metavalue(0, 0.02f * j);
+                if (res_version && res_metavalue && !version.empty()) {
+                    succeeded++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(succeeded.load(), session_count * 50);
+};
+
+/* 複数の接続先への接続を貸し出し、返却された接続を再利用できるか */
+TEST_F(GSAPI_TEST, TEST_GS_POOL) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    GsApiPoolConfig pool_config;
+    pool_config.endpoints = { gs_config, gs_config }; /* 同じツールを2つの接続先として扱う */
+    pool_config.connections_per_endpoint = 2;
+    gsapi_pool pool;
+    bool res = pool.open(pool_config);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(pool.check_idle(), 4u);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded(0);
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&pool, &succeeded]() {
+            for (int j = 0; j < 20; j++) {
+                gsapi_lease lease;
+                if (!pool.acquire(lease)) {
+                    continue;
+                }
+                std::string version;
+                if (lease->command_get_version(version)) {
+                    succeeded++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(succeeded.load(), 8 * 20);
+
+    gsapi_lease lease;
+    res = pool.acquire(1, lease);
+    EXPECT_EQ(res, true);
+    EXPECT_EQ(lease.get_endpoint(), 1u);
+    lease.release();
+    pool.close();
+};
+
+/* 応答を待たずに多数のコマンドを送り、非同期に受け取れるか */
+TEST_F(GSAPI_TEST, TEST_GS_ASYNC_COMMANDS) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_async_client async_client;
+    bool res = async_client.start(gs_config);
+    EXPECT_EQ(res, true);
+
+    std::atomic<int> completed(0);
+    std::vector<std::future<GsAsyncResult<std::string>>> versions;
+    for (int i = 0; i < 100; i++) {
+        versions.push_back(async_client.command_get_version(
+            [&completed](const GsAsyncResult<std::string>& result) {
+                if (result.result) {
+                    completed++;
+                }
+            }));
+    }
+    std::future<GsAsyncResult<float>> metavalue = async_client.command_get_metavalue(0);
+    for (auto& version : versions) {
+        const GsAsyncResult<std::string> result = version.get();
+        EXPECT_EQ(result.result, true);
+        EXPECT_EQ(result.value.empty(), false);
+    }
+    EXPECT_EQ(metavalue.get().result, true);
+    EXPECT_EQ(completed.load(), 100);
+    async_client.stop();
+};
+
+/* completionの中からI/Oスレッドを止められるか */
+TEST_F(GSAPI_TEST, TEST_GS_ASYNC_STOP_IN_COMPLETION) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_async_client async_client;
+    EXPECT_EQ(async_client.start(gs_config), true);
+
+    std::promise<void> stopped;
+    async_client.command_get_version([&async_client, &stopped](const GsAsyncResult<std::string>&) {
+        async_client.stop();
+        stopped.set_value();
+    });
+    EXPECT_EQ(stopped.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(async_client.is_running(), false);
+    async_client.stop();
+    EXPECT_EQ(async_client.start(gs_config), true);
+    async_client.stop();
+};
+
+/* 非同期コマンドの応答が届かないときは期限で失敗し、停止後は受け付けないか */
+TEST_F(GSAPI_TEST, TEST_GS_ASYNC_DEADLINE) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gs_config.receive_timeout_msec = 200;
+    gsapi_async_client async_client;
+    bool res = async_client.start(gs_config);
+    EXPECT_EQ(res, true);
+    std::future<GsAsyncResult<std::string>> response = async_client.send_command("get_version"); /* デリミタが無いのでツールは応答しない */
+    EXPECT_EQ(response.wait_for(std::chrono::milliseconds(1000)), std::future_status::ready);
+    EXPECT_EQ(response.get().result, false);
+    async_client.stop();
+    res = async_client.command_play().get().result;
+    EXPECT_EQ(res, false);
+};
+
+#if defined(__cpp_impl_coroutine)
+/* コルーチンの続きを指定したスレッドで実行するための単純な実行環境 */
+class gsapi_test_executor
+{
+public:
+    void post(std::function<void()> job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+        condition.notify_one();
+    }
+    /* 条件を満たすまで、このスレッドで投入された処理を実行する */
+    bool run_until(const std::function<bool()>& is_done, const std::chrono::milliseconds& timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!is_done()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!condition.wait_until(lock, deadline, [this]() { return !jobs.empty(); })) {
+                return false;
+            }
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+        }
+        return true;
+    }
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> jobs;
+};
+
+/* コマンドを順に待つスクリプト */
+static gsapi_task run_test_script(gsapi_coroutine_client& client, std::thread::id& resumed_thread, int& finished)
+{
+    GsAsyncResult<std::string> version = co_await client.command_get_version();
+    EXPECT_EQ(version.result, true);
+    GsAsyncResult<> set_result = co_await client.command_set_metavalue(0, 0.5f);
+    EXPECT_EQ(set_result.result, true);
+    GsAsyncResult<float> metavalue = co_await client.command_get_metavalue(0);
+    EXPECT_EQ(metavalue.result, true);
+    resumed_thread = std::this_thread::get_id();
+    finished++;
+}
+
+/* コルーチンから非同期コマンドを待ち、指定した実行環境で再開できるか */
+TEST_F(GSAPI_TEST, TEST_GS_COROUTINE) {
+    GsApiClientConfig gs_config;
+    gsapi_client::get_default_config(gs_config);
+    gsapi_async_client async_client;
+    EXPECT_EQ(async_client.start(gs_config), true);
+
+    gsapi_test_executor executor;
+    gsapi_coroutine_client client(async_client, [&executor](std::function<void()> job) { executor.post(std::move(job)); });
+    const int script_count = 100;
+    int finished = 0;
+    std::vector<std::thread::id> resumed_threads(script_count);
+    for (int i = 0; i < script_count; i++) {
+        run_test_script(client, resumed_threads[i], finished);
+    }
+    const bool res = executor.run_until([&finished]() { return finished == script_count; }, std::chrono::milliseconds(10000));
+    EXPECT_EQ(res, true);
+    for (const auto& resumed_thread : resumed_threads) {
+        EXPECT_EQ(resumed_thread, std::this_thread::get_id());
+    }
+    async_client.stop();
+};
+#endif
+
 /* ツールのバージョン */
 TEST_F(GSAPI_TEST, TEST_GSAPI_GET_VERSION) {
     std::string version;
@@ -371,6 +1331,23 @@ TEST_F(GSAPI_TEST, TEST_GSAPI_SET_METAVALUE_BY_NAME) {
     EXPECT_EQ(res, true);
 };
 
+/* 複数のメタパラメータに値をまとめて設定する */
+TEST_F(GSAPI_TEST, TEST_GSAPI_SET_METAVALUES) {
+    std::vector<GsMetaValueEntry> metavalues;
+    for (unsigned int i = 0; i < 40; i++) {
+        GsMetaValueEntry entry;
+        entry.target = 0u; /* パッチで定義されているメタパラメータの番号 */
+        entry.value = i / 40.f;
+        metavalues.push_back(entry);
+    }
+    GsMetaValueEntry entry_by_name;
+    entry_by_name.target = std::string("meta_param_01"); /* パッチで定義されているメタパラメータ名を指定 */
+    entry_by_name.value = 0.5f;
+    metavalues.push_back(entry_by_name);
+    const bool res = gsapi_client::command_set_metavalues(metavalues);
+    EXPECT_EQ(res, true);
+};
+
 /* オートメーションカーブ値を取得する。 */
 TEST_F(GSAPI_TEST, TEST_GSAPI_GET_CURVECOUNT) {
     unsigned int curve_count = 0;
@@ -446,6 +1423,20 @@ TEST_F(GSAPI_TEST, TEST_GSAPI_SET_CURVEVALUE_BY_NAME) {
     EXPECT_EQ(res, true);
 }
 
+/* 複数のオートメーションカーブに値をまとめて設定する。 */
+TEST_F(GSAPI_TEST, TEST_GSAPI_SET_CURVEVALUES) {
+    std::vector<GsCurveValueEntry> curve_values(2);
+    curve_values[0].target = 0u; /* パッチで定義されているオートメーションカーブの番号 */
+    curve_values[0].value.curve = { {0,0}, {1,1} };
+    curve_values[0].value.duration = 0.56f;
+    curve_values[1].target = std::string("Noise Amplitude"); /* パッチで定義されているオートメーションカーブの名前 */
+    curve_values[1].value.curve = { {0,1}, {1,0} };
+    curve_values[1].value.duration = 0.67f;
+    curve_values[1].value.is_loop = true;
+    const bool res = gsapi_client::command_set_curvevalues(curve_values);
+    EXPECT_EQ(res, true);
+}
+
 /* パッチを再生する */
 TEST_F(GSAPI_TEST, TEST_GSAPI_PLAY) {
     const bool res = gsapi_client::command_play();